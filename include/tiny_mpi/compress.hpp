@@ -0,0 +1,116 @@
+#ifndef TINY_MPI_CXX_INCLUDE_TINY_MPI_COMPRESS_HPP
+#define TINY_MPI_CXX_INCLUDE_TINY_MPI_COMPRESS_HPP
+
+#include "tiny_mpi/tiny_mpi.hpp"
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+/// Opt-in lossless compression for bandwidth-bound transfers.
+///
+/// Payloads are byte-shuffled, so the i-th byte of every element is stored
+/// contiguously, and then run-length encoded. Sparse or smoothly varying
+/// numeric arrays turn into long runs of zero and exponent bytes.
+///
+///     std::vector<double> all(n * tiny_mpi::n_ranks());
+///     fill(std::span(all).subspan(n * tiny_mpi::rank(), n));
+///     tiny_mpi::compressed_allgather(all);
+///
+/// Payloads smaller than `compression::threshold` bytes, and payloads that do
+/// not shrink, travel uncompressed. The receiver tells the two apart by the
+/// message size, so the fallback costs no extra copy or header. Both sides
+/// must use the same threshold. The calls are blocking, because the encoded
+/// buffer only lives for the duration of the call.
+namespace tiny_mpi
+{
+    struct compression
+    {
+        std::size_t threshold = 64 * 1024;      //!< smallest payload to compress, in bytes
+    };
+
+    /// Appends the encoding of `in`, shuffled at `width` bytes per element,
+    /// to `out`.
+    void compress(
+        std::span<std::byte const> in,          //!< raw payload
+        std::size_t width,                      //!< element size
+        std::vector<std::byte>& out) noexcept;  //!< encoded output
+
+    /// Decodes `in` into `out`, aborting unless it fills `out` exactly.
+    void decompress(
+        std::span<std::byte const> in,          //!< encoded payload
+        std::size_t width,                      //!< element size
+        std::span<std::byte> out,               //!< raw output
+        sloc_t = sloc_t::current()) noexcept;   //!< debugging location
+
+    void compressed_send(
+        std::span<std::byte const> from,        //!< raw payload
+        std::size_t width,                      //!< element size
+        rank_t to_rank,                         //!< destination
+        tag_t tag,                              //!< user defined tag
+        compression,                            //!< options
+        communicator const& comm,               //!< communicator
+        sloc_t = sloc_t::current()) noexcept;   //!< debugging location
+
+    void compressed_recv(
+        std::span<std::byte> to,                //!< raw payload
+        std::size_t width,                      //!< element size
+        rank_t from_rank,                       //!< source
+        tag_t tag,                              //!< user defined tag
+        compression,                            //!< options
+        communicator const& comm,               //!< communicator
+        sloc_t = sloc_t::current()) noexcept;   //!< debugging location
+
+    /// In place, rank i contributes bytes [i * block, (i + 1) * block).
+    void compressed_allgather(
+        std::span<std::byte> values,            //!< n_ranks * block bytes
+        std::size_t width,                      //!< element size
+        compression,                            //!< options
+        communicator const& comm,               //!< communicator
+        sloc_t = sloc_t::current()) noexcept;   //!< debugging location
+
+    template <std::ranges::contiguous_range Range>
+    void compressed_send(
+        Range const& from,
+        rank_t to_rank,
+        tag_t tag = 0,
+        compression c = {},
+        communicator const& comm = world(),
+        sloc_t sloc = sloc_t::current())
+        requires trivially_copyable<std::ranges::range_value_t<Range>>
+    {
+        using T = std::ranges::range_value_t<Range>;
+        compressed_send(std::as_bytes(std::span(from)), sizeof(T), to_rank, tag, c, comm, sloc);
+    }
+
+    /// Receives exactly `std::ranges::size(to)` elements.
+    template <std::ranges::contiguous_range Range>
+    void compressed_recv(
+        Range& to,
+        rank_t from_rank,
+        tag_t tag = 0,
+        compression c = {},
+        communicator const& comm = world(),
+        sloc_t sloc = sloc_t::current())
+        requires trivially_copyable<std::ranges::range_value_t<Range>>
+    {
+        using T = std::ranges::range_value_t<Range>;
+        compressed_recv(std::as_writable_bytes(std::span(to)), sizeof(T), from_rank, tag, c, comm, sloc);
+    }
+
+    /// Gathers in place like allgather(), each rank contributes
+    /// `size(values) / n_ranks` elements at its rank's offset.
+    template <std::ranges::contiguous_range Range>
+    void compressed_allgather(
+        Range& values,
+        compression c = {},
+        communicator const& comm = world(),
+        sloc_t sloc = sloc_t::current())
+        requires trivially_copyable<std::ranges::range_value_t<Range>>
+    {
+        using T = std::ranges::range_value_t<Range>;
+        compressed_allgather(std::as_writable_bytes(std::span(values)), sizeof(T), c, comm, sloc);
+    }
+}
+
+#endif // TINY_MPI_CXX_INCLUDE_TINY_MPI_COMPRESS_HPP
@@ -0,0 +1,157 @@
+#ifndef TINY_MPI_CXX_INCLUDE_TINY_MPI_COROUTINE_HPP
+#define TINY_MPI_CXX_INCLUDE_TINY_MPI_COROUTINE_HPP
+
+#include "tiny_mpi/tiny_mpi.hpp"
+
+#include <coroutine>
+#include <exception>
+#include <utility>
+#include <vector>
+
+namespace tiny_mpi
+{
+    /// A fire-and-forget coroutine, owned by the scheduler it is spawned on.
+    class task
+    {
+      public:
+        struct promise_type
+        {
+            auto get_return_object() noexcept -> task {
+                return task(std::coroutine_handle<promise_type>::from_promise(*this));
+            }
+
+            auto initial_suspend() const noexcept -> std::suspend_always {
+                return {};
+            }
+
+            auto final_suspend() const noexcept -> std::suspend_always {
+                return {};
+            }
+
+            void return_void() const noexcept {
+            }
+
+            void unhandled_exception() const noexcept {
+                std::terminate();
+            }
+        };
+
+        task(task&& b) noexcept
+                : _handle(std::exchange(b._handle, nullptr))
+        {
+        }
+
+        ~task() {
+            if (_handle) {
+                _handle.destroy();
+            }
+        }
+
+        /// Transfers ownership of the coroutine frame to the caller.
+        [[nodiscard]]
+        auto release() noexcept -> std::coroutine_handle<> {
+            return std::exchange(_handle, nullptr);
+        }
+
+      private:
+        explicit task(std::coroutine_handle<promise_type> h) noexcept
+                : _handle(h)
+        {
+        }
+
+        std::coroutine_handle<promise_type> _handle;
+    };
+
+    /// A single-threaded scheduler that resumes tasks as their requests complete.
+    ///
+    ///     tiny_mpi::scheduler s;
+    ///     s.spawn([&]() -> tiny_mpi::task {
+    ///         co_await s(tiny_mpi::recv(halo, left));
+    ///         compute(halo);
+    ///         co_await s(tiny_mpi::allreduce(residual));
+    ///     }());
+    ///     s.run();
+    ///
+    /// While tasks are ready the scheduler polls with MPI_Testsome between
+    /// batches, and only blocks in MPI_Waitsome once every task is suspended.
+    class scheduler
+    {
+        request_pool _pool;
+        std::vector<std::coroutine_handle<>> _waiting;  //!< indexed by pool slot
+        std::vector<std::coroutine_handle<>> _ready;
+        std::vector<std::coroutine_handle<>> _batch;
+
+        struct _request_awaiter
+        {
+            scheduler& _scheduler;
+            request_t _request;
+            sloc_t _sloc;
+
+            auto await_ready() noexcept -> bool {
+                int flag;
+                check(_sloc, tiny_mpi_check_op(MPI_Test), &_request, &flag, MPI_STATUS_IGNORE);
+                return flag;
+            }
+
+            void await_suspend(std::coroutine_handle<> h) {
+                _scheduler._suspend(_request, h);
+            }
+
+            void await_resume() const noexcept {
+            }
+        };
+
+        struct _yield_awaiter
+        {
+            scheduler& _scheduler;
+
+            auto await_ready() const noexcept -> bool {
+                return false;
+            }
+
+            void await_suspend(std::coroutine_handle<> h) {
+                _scheduler._ready.push_back(h);
+            }
+
+            void await_resume() const noexcept {
+            }
+        };
+
+      public:
+        scheduler() = default;
+        scheduler(scheduler const&) = delete;
+        auto operator=(scheduler const&) -> scheduler& = delete;
+
+        /// Destroys any tasks that have not run to completion, after waiting on
+        /// the requests they are suspended on.
+        ~scheduler();
+
+        /// Takes ownership of `t`, it will start during the next run().
+        void spawn(task t) {
+            _ready.push_back(t.release());
+        }
+
+        /// Resumes tasks until all of them have completed.
+        void run(
+            sloc_t = sloc_t::current()) noexcept;   //!< debugging location
+
+        /// Suspends the calling task until `r` completes.
+        [[nodiscard]]
+        auto operator()(request_t r, sloc_t sloc = sloc_t::current()) noexcept
+            -> _request_awaiter
+        {
+            return { *this, r, sloc };
+        }
+
+        /// Reschedules the calling task so outstanding requests can be polled.
+        [[nodiscard]]
+        auto yield() noexcept -> _yield_awaiter {
+            return { *this };
+        }
+
+      private:
+        void _suspend(request_t r, std::coroutine_handle<> h);
+    };
+}
+
+#endif // TINY_MPI_CXX_INCLUDE_TINY_MPI_COROUTINE_HPP
@@ -0,0 +1,176 @@
+#ifndef TINY_MPI_CXX_INCLUDE_TINY_MPI_HALO_HPP
+#define TINY_MPI_CXX_INCLUDE_TINY_MPI_HALO_HPP
+
+#include "tiny_mpi/tiny_mpi.hpp"
+#include "tiny_mpi/window.hpp"
+
+#include <map>
+#include <span>
+#include <vector>
+
+namespace tiny_mpi
+{
+    /// A repeated symmetric exchange with a fixed set of peers, e.g., a halo,
+    /// that bypasses the MPI message path for peers on the same node.
+    ///
+    /// Send buffers for on-node peers live in a node-shared segment and the
+    /// peer reads them in place, so the data is written once and never copied.
+    /// A zero-byte message per on-node peer orders the stores and loads.
+    /// Off-node peers fall back to nonblocking send() and recv().
+    ///
+    ///     tiny_mpi::halo_exchange<double> halo(neighbors, face_sizes);
+    ///     for (...) {
+    ///         for (std::size_t i = 0; i < neighbors.size(); ++i) {
+    ///             pack(i, halo.send_buffer(i));
+    ///         }
+    ///         halo.exchange();
+    ///         for (std::size_t i = 0; i < neighbors.size(); ++i) {
+    ///             unpack(i, halo.recv_buffer(i));
+    ///         }
+    ///     }
+    ///
+    /// Every peer must list this rank with the same count. A peer listed more
+    /// than once, e.g. both neighbors on a two-rank periodic ring, pairs its
+    /// entries as opposite directions: the k-th entry for a peer matches the
+    /// peer's (k ^ 1)-th entry for this rank, so list them as (left, right),
+    /// (down, up), and so on. Construction is collective over `comm`, and the
+    /// exchange runs on a private duplicate of it, so it never matches the
+    /// caller's own messages.
+    template <mpi_typed T>
+    class halo_exchange
+    {
+        communicator _comm;                     //!< private duplicate
+        communicator _node;                     //!< ranks sharing this node
+        std::vector<tag_t> _send_tags;          //!< per peer, by direction
+        std::vector<tag_t> _recv_tags;          //!< the peer's tag for this rank
+
+        std::vector<rank_t> _peers;
+        std::vector<count_t> _counts;
+        std::vector<rank_t> _node_peers;        //!< MPI_UNDEFINED when off-node
+        std::vector<count_t> _offsets;          //!< into the segment or staging
+
+        window<T> _segment;                     //!< two halves, double buffered
+        count_t _half = 0;
+        std::vector<T const*> _inbox;           //!< peer's outbox for this rank
+        std::vector<count_t> _inbox_half;
+
+        std::vector<T> _send;                   //!< off-node staging
+        std::vector<T> _recv;
+        std::vector<request_t> _requests;
+        int _parity = 0;
+
+      public:
+        halo_exchange(
+            std::span<rank_t const> peers,              //!< ranks in `comm`
+            std::span<count_t const> counts,            //!< elements per peer, both ways
+            tag_t tag = 0,                              //!< base tag, plus the direction index
+            communicator const& comm = world(),         //!< communicator
+            sloc_t sloc = sloc_t::current())            //!< debugging location
+                : _comm(comm.dup(sloc))
+                , _node(_comm.split_type(MPI_COMM_TYPE_SHARED, 0, sloc))
+                , _send_tags(peers.size())
+                , _recv_tags(peers.size())
+                , _peers(peers.begin(), peers.end())
+                , _counts(counts.begin(), counts.end())
+                , _node_peers(_comm.translate(peers, _node, sloc))
+                , _offsets(peers.size())
+                , _inbox(peers.size())
+                , _inbox_half(peers.size())
+        {
+            std::map<rank_t, int> total, seen;
+            for (rank_t p : _peers) {
+                ++total[p];
+            }
+            for (std::size_t i = 0; i < _peers.size(); ++i) {
+                int const k = seen[_peers[i]]++;
+                int const reverse = (k ^ 1) < total[_peers[i]] ? k ^ 1 : k;
+                _send_tags[i] = tag + k;
+                _recv_tags[i] = tag + reverse;
+            }
+
+            count_t staged = 0;
+            for (std::size_t i = 0; i < _peers.size(); ++i) {
+                count_t& total = on_node(i) ? _half : staged;
+                _offsets[i] = std::exchange(total, total + _counts[i]);
+            }
+            _send.resize(staged);
+            _recv.resize(staged);
+
+            _segment = window<T>::shared(2 * _half, _node, sloc);
+            _segment.lock_all(sloc);
+
+            // Each on-node peer reports where its outbox for this rank lives.
+            std::vector<std::array<count_t, 2>> layout(_peers.size());
+            std::vector<std::array<count_t, 2>> mine(_peers.size());
+            for (std::size_t i = 0; i < _peers.size(); ++i) {
+                if (on_node(i)) {
+                    mine[i] = { _offsets[i], _half };
+                    _requests.push_back(recv(layout[i].data(), 2, _peers[i], _recv_tags[i], _comm, sloc));
+                    _requests.push_back(send(mine[i].data(), 2, _peers[i], _send_tags[i], _comm, sloc));
+                }
+            }
+            wait(_requests, sloc);
+
+            for (std::size_t i = 0; i < _peers.size(); ++i) {
+                if (on_node(i)) {
+                    _inbox[i] = _segment.local(_node_peers[i], sloc).data() + layout[i][0];
+                    _inbox_half[i] = layout[i][1];
+                }
+            }
+        }
+
+        halo_exchange(halo_exchange&&) = default;
+
+        ~halo_exchange() {
+            if (_segment and not finalized()) {
+                _segment.unlock_all();
+            }
+        }
+
+        /// True if the `i`th peer shares this rank's node.
+        [[nodiscard]]
+        auto on_node(std::size_t i) const noexcept -> bool {
+            return _node_peers[i] != MPI_UNDEFINED;
+        }
+
+        /// Where to write the data for the `i`th peer before the next exchange().
+        [[nodiscard]]
+        auto send_buffer(std::size_t i) noexcept -> std::span<T> {
+            T* base = on_node(i) ? _segment.data() + _parity * _half : _send.data();
+            return { base + _offsets[i], std::size_t(_counts[i]) };
+        }
+
+        /// The data from the `i`th peer, valid until the next exchange().
+        [[nodiscard]]
+        auto recv_buffer(std::size_t i) const noexcept -> std::span<T const> {
+            T const* base = on_node(i) ? _inbox[i] + (1 - _parity) * _inbox_half[i] : _recv.data() + _offsets[i];
+            return { base, std::size_t(_counts[i]) };
+        }
+
+        /// Delivers every send_buffer() to its peer, blocking until every
+        /// recv_buffer() is ready.
+        void exchange(sloc_t sloc = sloc_t::current()) {
+            _segment.sync(sloc);
+
+            _requests.clear();
+            for (std::size_t i = 0; i < _peers.size(); ++i) {
+                if (on_node(i)) {
+                    request_t& r = _requests.emplace_back();
+                    check(sloc, tiny_mpi_check_op(MPI_Irecv), nullptr, 0, MPI_BYTE, _peers[i], _recv_tags[i], _comm, &r);
+                    request_t& s = _requests.emplace_back();
+                    check(sloc, tiny_mpi_check_op(MPI_Isend), nullptr, 0, MPI_BYTE, _peers[i], _send_tags[i], _comm, &s);
+                }
+                else {
+                    _requests.push_back(recv(_recv.data() + _offsets[i], _counts[i], _peers[i], _recv_tags[i], _comm, sloc));
+                    _requests.push_back(send(_send.data() + _offsets[i], _counts[i], _peers[i], _send_tags[i], _comm, sloc));
+                }
+            }
+            wait(_requests, sloc);
+
+            _segment.sync(sloc);
+            _parity ^= 1;
+        }
+    };
+}
+
+#endif // TINY_MPI_CXX_INCLUDE_TINY_MPI_HALO_HPP
@@ -0,0 +1,172 @@
+#ifndef TINY_MPI_CXX_INCLUDE_TINY_MPI_HIERARCHY_HPP
+#define TINY_MPI_CXX_INCLUDE_TINY_MPI_HIERARCHY_HPP
+
+#include "tiny_mpi/tiny_mpi.hpp"
+#include "tiny_mpi/window.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace tiny_mpi
+{
+    enum algorithm_t : int {
+        AUTOMATIC,                              //!< HIERARCHICAL at or above the threshold
+        FLAT,                                   //!< one collective over every rank
+        HIERARCHICAL                            //!< node, then leaders, then node
+    };
+
+    /// Node-aware allreduce() and allgather() over a communicator.
+    ///
+    /// Ranks on a node combine their data in a shared segment, one leader per
+    /// node runs the collective between nodes, and the other ranks read the
+    /// result back from the segment. Inter-node traffic shrinks by the number of
+    /// ranks per node.
+    ///
+    ///     tiny_mpi::node_hierarchy h;
+    ///     h.allreduce(gradients);
+    ///
+    /// The calls block and are collective over the communicator, and run on a
+    /// private duplicate of it. Reductions with non-commutative ops always take
+    /// the flat path.
+    class node_hierarchy
+    {
+        communicator _comm;                     //!< private duplicate
+        communicator _node;
+        communicator _leaders;                  //!< null on non-leaders
+
+        std::vector<int> _node_sizes;           //!< ranks per node, by leader rank
+        std::vector<int> _node_offsets;
+        std::vector<rank_t> _order;             //!< comm ranks, node by node
+        rank_t _position;                       //!< this rank in _order
+
+        window<char> _segment;
+        std::size_t _capacity = 0;              //!< bytes per node rank
+
+      public:
+        /// Messages of at least this many bytes go hierarchical under AUTOMATIC.
+        std::size_t threshold = 64 * 1024;
+
+        explicit node_hierarchy(
+            communicator const& comm = world(),     //!< communicator
+            sloc_t = sloc_t::current()) noexcept;   //!< debugging location
+
+        ~node_hierarchy();
+
+        [[nodiscard]]
+        auto node() const noexcept -> communicator const& {
+            return _node;
+        }
+
+        /// One rank per node, null on every other rank.
+        [[nodiscard]]
+        auto leaders() const noexcept -> communicator const& {
+            return _leaders;
+        }
+
+        template <mpi_typed T>
+        void allreduce(
+            T* buffer,
+            count_t n,
+            MPI_Op op = sum_op<T>(),
+            algorithm_t algorithm = AUTOMATIC,
+            sloc_t sloc = sloc_t::current())
+        {
+            if (_hierarchical(n * sizeof(T), algorithm)) {
+                _allreduce(buffer, n, sizeof(T), type<T>, op, sloc);
+            }
+            else {
+                wait(tiny_mpi::allreduce(buffer, n, op, _comm, sloc));
+            }
+        }
+
+        template <mpi_typed T, reduction_for<T> Op>
+        void allreduce(
+            T* buffer,
+            count_t n,
+            Op,
+            algorithm_t algorithm = AUTOMATIC,
+            sloc_t sloc = sloc_t::current())
+        {
+            allreduce(buffer, n, mpi_op<Op, T>(), algorithm, sloc);
+        }
+
+        template <std::ranges::contiguous_range Range>
+        void allreduce(
+            Range& v,
+            MPI_Op op = sum_op<std::ranges::range_value_t<Range>>(),
+            algorithm_t algorithm = AUTOMATIC,
+            sloc_t sloc = sloc_t::current())
+            requires mpi_typed<std::ranges::range_value_t<Range>>
+        {
+            allreduce(std::ranges::data(v), std::ranges::size(v), op, algorithm, sloc);
+        }
+
+        template <std::ranges::contiguous_range Range, class Op>
+        void allreduce(
+            Range& v,
+            Op,
+            algorithm_t algorithm = AUTOMATIC,
+            sloc_t sloc = sloc_t::current())
+            requires mpi_typed<std::ranges::range_value_t<Range>>
+                and reduction_for<Op, std::ranges::range_value_t<Range>>
+        {
+            allreduce(v, mpi_op<Op, std::ranges::range_value_t<Range>>(), algorithm, sloc);
+        }
+
+        /// Gathers in place like tiny_mpi::allgather(), each rank contributes
+        /// the `count` elements at `values + rank * count`.
+        template <mpi_typed T>
+        void allgather(
+            T* values,
+            count_t count,
+            algorithm_t algorithm = AUTOMATIC,
+            sloc_t sloc = sloc_t::current())
+        {
+            if (_hierarchical(_comm.n_ranks() * count * sizeof(T), algorithm)) {
+                _allgather(values, count, sizeof(T), type<T>, sloc);
+            }
+            else {
+                wait(tiny_mpi::allgather(values, count, _comm, sloc));
+            }
+        }
+
+        /// The block size is `size(values) / n_ranks`.
+        template <std::ranges::contiguous_range Range>
+        void allgather(
+            Range& values,
+            algorithm_t algorithm = AUTOMATIC,
+            sloc_t sloc = sloc_t::current())
+            requires mpi_typed<std::ranges::range_value_t<Range>>
+        {
+            allgather(std::ranges::data(values), std::ranges::size(values) / _comm.n_ranks(), algorithm, sloc);
+        }
+
+      private:
+        auto _hierarchical(std::size_t bytes, algorithm_t algorithm) const noexcept -> bool {
+            return algorithm == HIERARCHICAL or (algorithm == AUTOMATIC and threshold <= bytes);
+        }
+
+        /// Grows the shared segment to at least `bytes` per node rank.
+        void _reserve(std::size_t bytes, sloc_t sloc) noexcept;
+
+        /// Orders segment stores before the barrier and loads after it.
+        void _fence(sloc_t sloc) const noexcept;
+
+        void _allreduce(
+            void* buffer,
+            count_t n,
+            std::size_t size,
+            MPI_Datatype type,
+            MPI_Op op,
+            sloc_t sloc) noexcept;
+
+        void _allgather(
+            void* values,
+            count_t count,
+            std::size_t size,
+            MPI_Datatype type,
+            sloc_t sloc) noexcept;
+    };
+}
+
+#endif // TINY_MPI_CXX_INCLUDE_TINY_MPI_HIERARCHY_HPP
@@ -0,0 +1,51 @@
+#ifndef TINY_MPI_CXX_INCLUDE_TINY_MPI_KERNELS_HPP
+#define TINY_MPI_CXX_INCLUDE_TINY_MPI_KERNELS_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+/// Vectorized `inout[i] = op(in[i], inout[i])` kernels for custom reductions.
+///
+/// The instruction set (AVX-512, AVX2, or scalar) is selected once at runtime.
+/// A custom reduction can use them through its bulk overload:
+///
+///     struct fast_sum {
+///         static constexpr bool commutative = true;
+///         auto operator()(float a, float b) const { return a + b; }
+///         void operator()(float const* in, float* inout, std::size_t n) const {
+///             tiny_mpi::kernels::sum(in, inout, n);
+///         }
+///     };
+namespace tiny_mpi::kernels
+{
+    enum isa_t : int {
+        SCALAR,
+        AVX2,
+        AVX512
+    };
+
+    /// The instruction set the kernels dispatch to on this machine.
+    auto isa() noexcept -> isa_t;
+
+    void sum(float const* in, float* inout, std::size_t n) noexcept;
+    void sum(double const* in, double* inout, std::size_t n) noexcept;
+    void sum(std::int32_t const* in, std::int32_t* inout, std::size_t n) noexcept;
+    void sum(std::int64_t const* in, std::int64_t* inout, std::size_t n) noexcept;
+
+    void prod(float const* in, float* inout, std::size_t n) noexcept;
+    void prod(double const* in, double* inout, std::size_t n) noexcept;
+    void prod(std::int32_t const* in, std::int32_t* inout, std::size_t n) noexcept;
+    void prod(std::int64_t const* in, std::int64_t* inout, std::size_t n) noexcept;
+
+    void min(float const* in, float* inout, std::size_t n) noexcept;
+    void min(double const* in, double* inout, std::size_t n) noexcept;
+    void min(std::int32_t const* in, std::int32_t* inout, std::size_t n) noexcept;
+    void min(std::int64_t const* in, std::int64_t* inout, std::size_t n) noexcept;
+
+    void max(float const* in, float* inout, std::size_t n) noexcept;
+    void max(double const* in, double* inout, std::size_t n) noexcept;
+    void max(std::int32_t const* in, std::int32_t* inout, std::size_t n) noexcept;
+    void max(std::int64_t const* in, std::int64_t* inout, std::size_t n) noexcept;
+}
+
+#endif // TINY_MPI_CXX_INCLUDE_TINY_MPI_KERNELS_HPP
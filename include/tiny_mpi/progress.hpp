@@ -0,0 +1,81 @@
+#ifndef TINY_MPI_CXX_INCLUDE_TINY_MPI_PROGRESS_HPP
+#define TINY_MPI_CXX_INCLUDE_TINY_MPI_PROGRESS_HPP
+
+#include "tiny_mpi/tiny_mpi.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace tiny_mpi
+{
+    /// A background thread that drives outstanding requests to completion.
+    ///
+    /// Many MPI implementations only make progress inside MPI calls, so a large
+    /// nonblocking allreduce() posted before a long compute phase may not
+    /// advance until the next wait(). Handing the request to a progress_engine
+    /// keeps it moving with MPI_Testsome on a dedicated thread.
+    ///
+    ///     tiny_mpi::progress_engine engine;
+    ///     auto done = engine.submit(tiny_mpi::allreduce(big));
+    ///     compute();
+    ///     done.wait();
+    ///
+    /// Requires init(THREAD_MULTIPLE). Completion callbacks run on the progress
+    /// thread and must not block. The thread sleeps while no request is
+    /// outstanding.
+    class progress_engine
+    {
+        using _callback_t = std::function<void()>;
+
+        std::mutex _lock;
+        std::vector<std::pair<request_t, _callback_t>> _incoming;
+        std::atomic<bool> _stop = false;
+        std::condition_variable _wake;          //!< while no request is outstanding
+
+        request_pool _pool;                     //!< owned by the progress thread
+        std::vector<_callback_t> _callbacks;    //!< indexed by pool slot
+        std::thread _thread;
+
+      public:
+        /// Aborts if MPI was not initialized with THREAD_MULTIPLE.
+        explicit progress_engine(
+            sloc_t = sloc_t::current()) noexcept;   //!< debugging location
+
+        progress_engine(progress_engine const&) = delete;
+        auto operator=(progress_engine const&) -> progress_engine& = delete;
+
+        /// Completes all submitted requests before joining the thread.
+        ~progress_engine();
+
+        /// Takes ownership of `r` and calls `f` on the progress thread once it
+        /// completes.
+        void submit(request_t r, std::invocable auto&& f) {
+            {
+                std::scoped_lock _(_lock);
+                _incoming.emplace_back(r, TINY_MPI_FWD(f));
+            }
+            _wake.notify_one();
+        }
+
+        /// Takes ownership of `r` and returns a future that is ready once it
+        /// completes.
+        [[nodiscard]]
+        auto submit(request_t r) -> std::future<void> {
+            auto p = std::make_shared<std::promise<void>>();
+            auto f = p->get_future();
+            submit(r, [p = std::move(p)] { p->set_value(); });
+            return f;
+        }
+
+      private:
+        void _run(sloc_t sloc) noexcept;
+    };
+}
+
+#endif // TINY_MPI_CXX_INCLUDE_TINY_MPI_PROGRESS_HPP
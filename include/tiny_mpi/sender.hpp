@@ -0,0 +1,378 @@
+#ifndef TINY_MPI_CXX_INCLUDE_TINY_MPI_SENDER_HPP
+#define TINY_MPI_CXX_INCLUDE_TINY_MPI_SENDER_HPP
+
+#include "tiny_mpi/tiny_mpi.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+/// Sender adapters in the style of P2300 (std::execution).
+///
+/// The standard library does not ship std::execution yet, so this is a small
+/// self-contained subset of the model: senders are lazy descriptions of work
+/// with a `value_type` (possibly void) and a `connect(receiver)` member that
+/// returns an operation state with `start()`; receivers provide
+/// `set_value(...)`. MPI operations are posted when started and completed by a
+/// run_loop, and compose with then() and when_all().
+///
+///     tiny_mpi::exec::run_loop loop;
+///     auto step = tiny_mpi::exec::when_all(
+///         tiny_mpi::exec::recv(loop, halo, left),
+///         tiny_mpi::exec::schedule(loop) | tiny_mpi::exec::then(compute_interior))
+///         | tiny_mpi::exec::then(compute_boundary);
+///     tiny_mpi::exec::sync_wait(loop, std::move(step));
+///
+/// Lvalue arguments to the MPI sender factories are captured by reference and
+/// must outlive the operation, rvalues are captured by value.
+namespace tiny_mpi::exec
+{
+    template <class S>
+    using value_t = typename std::remove_cvref_t<S>::value_type;
+
+    template <class S>
+    using _value_or_monostate_t = std::conditional_t<std::is_void_v<value_t<S>>, std::monostate, value_t<S>>;
+
+    /// A single-threaded progress loop that completes operations as their
+    /// requests finish.
+    class run_loop
+    {
+      public:
+        struct _task {
+            void (*_complete)(_task*) noexcept;
+        };
+
+      private:
+        request_pool _pool;
+        std::vector<_task*> _waiting;  //!< indexed by pool slot
+        std::vector<_task*> _ready;
+        std::vector<_task*> _batch;
+
+      public:
+        run_loop() = default;
+        run_loop(run_loop const&) = delete;
+        auto operator=(run_loop const&) -> run_loop& = delete;
+
+        /// Completes the ready operations and polls with MPI_Testsome, or blocks
+        /// in MPI_Waitsome if nothing is ready. Returns false when idle.
+        auto run_once(
+            sloc_t = sloc_t::current()) noexcept    //!< debugging location
+            -> bool;
+
+        /// Runs until every operation has completed.
+        void run(sloc_t sloc = sloc_t::current()) noexcept {
+            while (run_once(sloc)) {
+            }
+        }
+
+        void _push(_task* t) {
+            _ready.push_back(t);
+        }
+
+        void _post(request_t r, _task* t);
+    };
+
+    /// A sender that posts the request returned by `_post()` when started, and
+    /// completes once the request does.
+    template <class F>
+    struct _request_sender
+    {
+        using value_type = void;
+
+        run_loop* _loop;
+        F _post;
+
+        template <class R>
+        struct _op : run_loop::_task
+        {
+            run_loop* _loop;
+            F _post;
+            R _receiver;
+
+            _op(run_loop* loop, F post, R receiver)
+                    : _task { &_complete }
+                    , _loop(loop)
+                    , _post(std::move(post))
+                    , _receiver(std::move(receiver))
+            {
+            }
+
+            void start() noexcept {
+                _loop->_post(_post(), this);
+            }
+
+            static void _complete(run_loop::_task* t) noexcept {
+                static_cast<_op*>(t)->_receiver.set_value();
+            }
+        };
+
+        template <class R>
+        auto connect(R receiver) const -> _op<R> {
+            return { _loop, _post, std::move(receiver) };
+        }
+    };
+
+    /// A sender that completes on the next iteration of the run_loop, used to
+    /// start compute work that should overlap with outstanding communication.
+    struct _schedule_sender
+    {
+        using value_type = void;
+
+        run_loop* _loop;
+
+        template <class R>
+        struct _op : run_loop::_task
+        {
+            run_loop* _loop;
+            R _receiver;
+
+            _op(run_loop* loop, R receiver)
+                    : _task { &_complete }
+                    , _loop(loop)
+                    , _receiver(std::move(receiver))
+            {
+            }
+
+            void start() noexcept {
+                _loop->_push(this);
+            }
+
+            static void _complete(run_loop::_task* t) noexcept {
+                static_cast<_op*>(t)->_receiver.set_value();
+            }
+        };
+
+        template <class R>
+        auto connect(R receiver) const -> _op<R> {
+            return { _loop, std::move(receiver) };
+        }
+    };
+
+    [[nodiscard]]
+    inline auto schedule(run_loop& loop) noexcept -> _schedule_sender {
+        return { &loop };
+    }
+
+    template <class F, class S>
+    struct _then_result {
+        using type = std::invoke_result_t<F&, value_t<S>>;
+    };
+
+    template <class F, class S> requires std::is_void_v<value_t<S>>
+    struct _then_result<F, S> {
+        using type = std::invoke_result_t<F&>;
+    };
+
+    template <class S, class F>
+    struct _then_sender
+    {
+        using value_type = typename _then_result<F, S>::type;
+
+        S _sender;
+        F _f;
+
+        template <class R>
+        struct _then_receiver
+        {
+            F _f;
+            R _receiver;
+
+            void set_value(auto&&... vs) noexcept {
+                if constexpr (std::is_void_v<value_type>) {
+                    std::invoke(_f, TINY_MPI_FWD(vs)...);
+                    _receiver.set_value();
+                }
+                else {
+                    _receiver.set_value(std::invoke(_f, TINY_MPI_FWD(vs)...));
+                }
+            }
+        };
+
+        template <class R>
+        auto connect(R receiver) const {
+            return _sender.connect(_then_receiver<R> { _f, std::move(receiver) });
+        }
+    };
+
+    /// Invokes `f` with the value of `s` and completes with its result.
+    template <class S, class F>
+    [[nodiscard]]
+    auto then(S s, F f) -> _then_sender<S, F> {
+        return { std::move(s), std::move(f) };
+    }
+
+    template <class F>
+    struct _then_closure {
+        F _f;
+
+        template <class S>
+        friend auto operator|(S s, _then_closure c) -> _then_sender<S, F> {
+            return { std::move(s), std::move(c._f) };
+        }
+    };
+
+    /// The pipeable form, `s | then(f)`.
+    template <class F>
+    [[nodiscard]]
+    auto then(F f) -> _then_closure<F> {
+        return { std::move(f) };
+    }
+
+    template <class... Ss>
+    struct _when_all_sender
+    {
+        static constexpr bool _all_void = (std::is_void_v<value_t<Ss>> and ...);
+
+        /// Void if every child is void, otherwise a tuple with one element per
+        /// child where void children contribute std::monostate.
+        using value_type = std::conditional_t<_all_void, void, std::tuple<_value_or_monostate_t<Ss>...>>;
+
+        std::tuple<Ss...> _senders;
+
+        template <class R>
+        struct _shared
+        {
+            std::size_t _remaining = sizeof...(Ss);
+            std::tuple<_value_or_monostate_t<Ss>...> _values;
+            R _receiver;
+
+            explicit _shared(R receiver)
+                    : _receiver(std::move(receiver))
+            {
+            }
+
+            void _arrive() noexcept {
+                if (--_remaining == 0) {
+                    if constexpr (_all_void) {
+                        _receiver.set_value();
+                    }
+                    else {
+                        _receiver.set_value(std::move(_values));
+                    }
+                }
+            }
+        };
+
+        template <class R, std::size_t I>
+        struct _child
+        {
+            _shared<R>* _state;
+
+            void set_value(auto&&... vs) noexcept {
+                if constexpr (sizeof...(vs) != 0) {
+                    std::get<I>(_state->_values) = (TINY_MPI_FWD(vs), ...);
+                }
+                _state->_arrive();
+            }
+        };
+
+        template <class R, std::size_t... Is>
+        static auto _connect(std::tuple<Ss...> const& senders, _shared<R>* state, std::index_sequence<Is...>) {
+            return std::tuple { std::get<Is>(senders).connect(_child<R, Is> { state })... };
+        }
+
+        template <class R>
+        struct _op
+        {
+            std::unique_ptr<_shared<R>> _state;
+            decltype(_connect<R>(std::declval<std::tuple<Ss...> const&>(), nullptr, std::index_sequence_for<Ss...>{})) _ops;
+
+            void start() noexcept {
+                std::apply([](auto&... ops) { (ops.start(), ...); }, _ops);
+            }
+        };
+
+        template <class R>
+        auto connect(R receiver) const -> _op<R> {
+            auto state = std::make_unique<_shared<R>>(std::move(receiver));
+            auto ops = _connect<R>(_senders, state.get(), std::index_sequence_for<Ss...>{});
+            return { std::move(state), std::move(ops) };
+        }
+    };
+
+    /// Completes once every child has completed.
+    template <class... Ss>
+    [[nodiscard]]
+    auto when_all(Ss... ss) -> _when_all_sender<Ss...> {
+        return { std::tuple { std::move(ss)... } };
+    }
+
+    template <class V>
+    struct _sync_wait_receiver
+    {
+        bool* _done;
+        std::optional<V>* _value;
+
+        void set_value(auto&&... vs) noexcept {
+            if constexpr (sizeof...(vs) != 0) {
+                _value->emplace(TINY_MPI_FWD(vs)...);
+            }
+            *_done = true;
+        }
+    };
+
+    /// Starts `s` and drives `loop` until it completes, returning its value.
+    template <class S>
+    auto sync_wait(run_loop& loop, S s, sloc_t sloc = sloc_t::current())
+        -> value_t<S>
+    {
+        bool done = false;
+        std::optional<_value_or_monostate_t<S>> value;
+
+        auto op = s.connect(_sync_wait_receiver<_value_or_monostate_t<S>> { &done, &value });
+        op.start();
+        while (not done and loop.run_once(sloc)) {
+        }
+
+        if (not done) {
+            print_error("tiny_mpi::exec::sync_wait", MPI_ERR_PENDING, sloc);
+            abort(MPI_ERR_PENDING, sloc);
+        }
+
+        if constexpr (not std::is_void_v<value_t<S>>) {
+            return std::move(*value);
+        }
+    }
+
+    template <class F, class... Ts>
+    auto _defer(run_loop& loop, F f, Ts&&... ts) {
+        auto post = [f, args = std::tuple<Ts...>(TINY_MPI_FWD(ts)...)]() mutable {
+            return std::apply(f, args);
+        };
+        return _request_sender<decltype(post)> { &loop, std::move(post) };
+    }
+
+    /// Sender forms of the nonblocking wrappers, they accept the same arguments.
+    [[nodiscard]]
+    auto send(run_loop& loop, auto&&... ts) {
+        return _defer(loop, [](auto&... as) { return tiny_mpi::send(as...); }, TINY_MPI_FWD(ts)...);
+    }
+
+    [[nodiscard]]
+    auto recv(run_loop& loop, auto&&... ts) {
+        return _defer(loop, [](auto&... as) { return tiny_mpi::recv(as...); }, TINY_MPI_FWD(ts)...);
+    }
+
+    [[nodiscard]]
+    auto allreduce(run_loop& loop, auto&&... ts) {
+        return _defer(loop, [](auto&... as) { return tiny_mpi::allreduce(as...); }, TINY_MPI_FWD(ts)...);
+    }
+
+    [[nodiscard]]
+    auto allgather(run_loop& loop, auto&&... ts) {
+        return _defer(loop, [](auto&... as) { return tiny_mpi::allgather(as...); }, TINY_MPI_FWD(ts)...);
+    }
+
+    [[nodiscard]]
+    auto barrier(run_loop& loop, auto&&... ts) {
+        return _defer(loop, [](auto&... as) { return tiny_mpi::barrier(as...); }, TINY_MPI_FWD(ts)...);
+    }
+}
+
+#endif // TINY_MPI_CXX_INCLUDE_TINY_MPI_SENDER_HPP
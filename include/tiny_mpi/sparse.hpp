@@ -0,0 +1,105 @@
+#ifndef TINY_MPI_CXX_INCLUDE_TINY_MPI_SPARSE_HPP
+#define TINY_MPI_CXX_INCLUDE_TINY_MPI_SPARSE_HPP
+
+#include "tiny_mpi/tiny_mpi.hpp"
+
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace tiny_mpi
+{
+    /// Sparse dynamic data exchange with the NBX algorithm: sends
+    /// `messages[i]` to `destinations[i]` and calls `f(source, message)` for
+    /// every message sent to this rank, by ranks it does not know in advance.
+    /// There must be exactly one destination per message.
+    ///
+    /// Messages go out with MPI_Issend, so a completed send means it was
+    /// matched. Once all of its sends complete, a rank joins an MPI_Ibarrier
+    /// while it keeps receiving with MPI_Improbe/MPI_Mrecv. When the barrier
+    /// completes, every message has been received. The cost scales with the
+    /// number of messages, and no rank exchanges a P-length count vector.
+    ///
+    /// Blocks until the exchange is complete. No other traffic may use `tag`
+    /// on `comm` meanwhile, and back-to-back exchanges should alternate tags
+    /// since a fast rank may start the next one before a slow one has left.
+    template <std::ranges::input_range Messages>
+    void sparse_exchange(
+        std::span<rank_t const> destinations,
+        Messages const& messages,
+        auto&& f,
+        tag_t tag = 0,
+        communicator const& comm = world(),
+        sloc_t sloc = sloc_t::current())
+        requires std::ranges::sized_range<Messages>
+            and std::ranges::contiguous_range<std::ranges::range_value_t<Messages>>
+            and mpi_typed<std::ranges::range_value_t<std::ranges::range_value_t<Messages>>>
+            and std::invocable<decltype(f)&, rank_t, std::span<std::ranges::range_value_t<std::ranges::range_value_t<Messages>>>>
+    {
+        using T = std::ranges::range_value_t<std::ranges::range_value_t<Messages>>;
+
+        if (std::ranges::size(messages) != destinations.size()) {
+            print_error("MPI_Issend", MPI_ERR_COUNT, sloc);
+            abort(MPI_ERR_COUNT, sloc);
+        }
+
+        std::vector<request_t> sends;
+        auto to = destinations.begin();
+        for (auto const& message : messages) {
+            auto const [m, t] = large(type<T>, std::ranges::size(message), sloc);
+            request_t& r = sends.emplace_back();
+            check(sloc, tiny_mpi_large_op(MPI_Issend), std::ranges::data(message), m, t, *to++, tag, comm, &r);
+        }
+
+        std::vector<T> message;
+        request_t barrier = MPI_REQUEST_NULL;
+        for (bool done = false; not done;) {
+            int flag;
+            MPI_Message m;
+            MPI_Status status;
+            check(sloc, tiny_mpi_check_op(MPI_Improbe), MPI_ANY_SOURCE, tag, comm, &flag, &m, &status);
+            if (flag) {
+                message.resize(get_count(status, type<T>, sloc));
+                auto const [k, t] = large(type<T>, ssize(message), sloc);
+                check(sloc, tiny_mpi_large_op(MPI_Mrecv), message.data(), k, t, &m, MPI_STATUS_IGNORE);
+                f(rank_t(status.MPI_SOURCE), std::span<T>(message));
+            }
+            else if (barrier == MPI_REQUEST_NULL) {
+                int sent;
+                check(sloc, tiny_mpi_check_op(MPI_Testall), ssize(sends), data(sends), &sent, MPI_STATUSES_IGNORE);
+                if (sent) {
+                    check(sloc, tiny_mpi_check_op(MPI_Ibarrier), comm, &barrier);
+                }
+            }
+            else {
+                int all;
+                check(sloc, tiny_mpi_check_op(MPI_Test), &barrier, &all, MPI_STATUS_IGNORE);
+                done = all;
+            }
+        }
+    }
+
+    /// Returns the received {source, message} pairs in arrival order.
+    template <std::ranges::input_range Messages>
+    [[nodiscard]]
+    auto sparse_exchange(
+        std::span<rank_t const> destinations,
+        Messages const& messages,
+        tag_t tag = 0,
+        communicator const& comm = world(),
+        sloc_t sloc = sloc_t::current())
+        requires std::ranges::sized_range<Messages>
+            and std::ranges::contiguous_range<std::ranges::range_value_t<Messages>>
+            and mpi_typed<std::ranges::range_value_t<std::ranges::range_value_t<Messages>>>
+    {
+        using T = std::ranges::range_value_t<std::ranges::range_value_t<Messages>>;
+
+        std::vector<std::pair<rank_t, std::vector<T>>> out;
+        sparse_exchange(destinations, messages, [&](rank_t source, std::span<T> message) {
+            out.emplace_back(source, std::vector<T>(message.begin(), message.end()));
+        }, tag, comm, sloc);
+        return out;
+    }
+}
+
+#endif // TINY_MPI_CXX_INCLUDE_TINY_MPI_SPARSE_HPP
@@ -0,0 +1,97 @@
+#ifndef TINY_MPI_CXX_INCLUDE_TINY_MPI_TERMINATION_HPP
+#define TINY_MPI_CXX_INCLUDE_TINY_MPI_TERMINATION_HPP
+
+#include "tiny_mpi/tiny_mpi.hpp"
+
+#include <array>
+#include <span>
+#include <vector>
+
+namespace tiny_mpi
+{
+    /// Detects global quiescence of a message-driven computation.
+    ///
+    /// Each rank counts the messages it sends and receives. While idle, ranks
+    /// run waves of nonblocking allreduce() over the two counters. The
+    /// computation has terminated once two consecutive waves see the same
+    /// totals with every sent message received (Mattern's four-counter method).
+    /// Waves only advance inside test(), so a rank keeps receiving while one is
+    /// in flight, and no rank blocks in a synchronous round. The waves run on
+    /// a private duplicate of the communicator, so they never interleave with
+    /// the caller's own collectives.
+    ///
+    ///     tiny_mpi::termination_detector td;
+    ///     seed(td);
+    ///     td.drain<vertex_t>(tag, [&](tiny_mpi::rank_t, std::span<vertex_t> v) {
+    ///         visit(v, td);                   // td.sent() for every send()
+    ///     });
+    class termination_detector
+    {
+        communicator _comm;                     //!< borrowed, for drain()
+        communicator _waves;                    //!< private duplicate
+        std::array<count_t, 2> _counts {};      //!< {sent, received} on this rank
+        std::array<count_t, 2> _wave {};        //!< totals of the wave in flight
+        std::array<count_t, 2> _last { -1, -1 };//!< totals of the previous wave
+        request_t _request = MPI_REQUEST_NULL;
+        bool _done = false;
+
+      public:
+        explicit termination_detector(
+            communicator const& comm = world(),     //!< communicator
+            sloc_t = sloc_t::current()) noexcept;   //!< debugging location
+
+        termination_detector(termination_detector const&) = delete;
+        auto operator=(termination_detector const&) -> termination_detector& = delete;
+
+        /// Completes a wave in flight.
+        ~termination_detector();
+
+        /// Counts `n` messages sent by this rank.
+        void sent(count_t n = 1) noexcept {
+            _counts[0] += n;
+        }
+
+        /// Counts `n` messages received by this rank.
+        void received(count_t n = 1) noexcept {
+            _counts[1] += n;
+        }
+
+        /// Advances the termination waves without blocking, returns true once
+        /// every rank is idle and no message is in flight. Call only while this
+        /// rank has no local work, every rank sees true on the same wave.
+        [[nodiscard]]
+        auto test(
+            sloc_t = sloc_t::current()) noexcept    //!< debugging location
+            -> bool;
+
+        /// Receives messages of `T` with `tag` from any source and hands them to
+        /// `f(source, message)` until termination, counting each as received.
+        /// `f` must count its own sends with sent().
+        template <mpi_typed T>
+        void drain(
+            tag_t tag,
+            std::invocable<rank_t, std::span<T>> auto&& f,
+            sloc_t sloc = sloc_t::current())
+        {
+            std::vector<T> message;
+            while (not _done) {
+                int flag;
+                MPI_Message m;
+                MPI_Status status;
+                check(sloc, tiny_mpi_check_op(MPI_Improbe), MPI_ANY_SOURCE, tag, _comm, &flag, &m, &status);
+                if (not flag) {
+                    (void)test(sloc);
+                    continue;
+                }
+
+                message.resize(get_count(status, type<T>, sloc));
+                auto const [k, t] = large(type<T>, ssize(message), sloc);
+                check(sloc, tiny_mpi_large_op(MPI_Mrecv), message.data(), k, t, &m, MPI_STATUS_IGNORE);
+                received();
+                f(status.MPI_SOURCE, std::span<T>(message));
+            }
+        }
+    };
+}
+
+#endif // TINY_MPI_CXX_INCLUDE_TINY_MPI_TERMINATION_HPP
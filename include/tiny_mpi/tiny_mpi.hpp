@@ -1,6 +1,8 @@
 #ifndef TINY_MPI_CXX_INCLUDE_TINY_MPI_TINY_MPI_HPP
 #define TINY_MPI_CXX_INCLUDE_TINY_MPI_TINY_MPI_HPP
 
+#include "tiny_mpi/kernels.hpp"
+
 #include <mpi.h>
 
 #include <version>
@@ -11,10 +13,19 @@
 #include <experimental/source_location>
 #endif
 
+#include <algorithm>
+#include <array>
 #include <concepts>
 #include <functional>
+#include <limits>
+#include <numeric>
+#ifdef __cpp_lib_mdspan
+#include <mdspan>
+#endif
 #include <ranges>
 #include <span>
+#include <tuple>
+#include <utility>
 #include <vector>
 
 #define TINY_MPI_FWD(x) static_cast<decltype(x)&&>(x)
@@ -31,6 +42,7 @@ namespace tiny_mpi
     using request_t = MPI_Request;
     using rank_t = int;
     using tag_t = int;
+    using count_t = MPI_Count;
 
     enum thread_support_t : int {
         THREAD_SINGLE = MPI_THREAD_FUNNELED,
@@ -44,13 +56,36 @@ namespace tiny_mpi
         { std::remove_cvref_t<T>::mpi_type() } -> std::same_as<MPI_Datatype>;
     };
 
+    /// Commits `type` and releases it in fini(), predefined types are returned
+    /// unchanged.
+    auto commit_type(
+        MPI_Datatype type,                      //!< datatype to commit
+        sloc_t = sloc_t::current()) noexcept    //!< debugging location
+        -> MPI_Datatype;
+
+    /// Calls T::mpi_type() once, commits the result, and caches it.
+    ///
+    /// The cached datatype is owned by tiny_mpi and freed in fini(), so
+    /// mpi_type() should return a fresh (committed or uncommitted) type and
+    /// not free it itself.
     template <user_defined_type T>
     struct DeferredType {
         operator MPI_Datatype() const {
-            return std::remove_cvref_t<T>::mpi_type();
+            static MPI_Datatype const t = commit_type(std::remove_cvref_t<T>::mpi_type());
+            return t;
         }
     };
 
+    /// Builds, commits, and registers an MPI_Type_create_struct datatype resized
+    /// to `extent`.
+    auto make_struct_type(
+        std::span<int const> lengths,           //!< field block lengths
+        std::span<MPI_Aint const> offsets,      //!< field byte offsets
+        std::span<MPI_Datatype const> types,    //!< field element types
+        MPI_Aint extent,                        //!< sizeof the aggregate
+        sloc_t = sloc_t::current()) noexcept    //!< debugging location
+        -> MPI_Datatype;
+
     /// Simple variable template to map arithmatic types to their MPI equivalents.
     template <class T> inline constexpr auto type = std::false_type{};
     // template <> constexpr MPI_Datatype type<std::byte>          = MPI_BYTE;
@@ -88,7 +123,90 @@ namespace tiny_mpi
     template <class T> requires std::is_enum_v<T>
     inline MPI_Datatype const type<T> = type<std::underlying_type_t<T>>;
 
+    /// Variable template that lists the member pointers of an aggregate, so that
+    /// its MPI datatype can be derived automatically.
+    ///
+    ///     struct particle { double x[3]; float m; int id; };
+    ///     TINY_MPI_FIELDS(particle, &particle::x, &particle::m, &particle::id);
+    ///
+    /// Members must themselves be mpi_typed (possibly nested described types),
+    /// or arrays of them.
+    template <class T> inline constexpr auto fields = std::false_type{};
+
+#define TINY_MPI_FIELDS(T, ...)                                         \
+    template <> inline constexpr auto tiny_mpi::fields<T> = std::tuple { __VA_ARGS__ }
+
+    template <class T>
+    concept described_type = not user_defined_type<T>
+        and not std::same_as<decltype(fields<std::remove_cvref_t<T>>), std::false_type const>;
+
+    template <class> struct _member;
+    template <class M, class C> struct _member<M C::*> { using type = M; };
+
+    template <class T, std::size_t I>
+    using _field_t = typename _member<std::tuple_element_t<I, std::remove_cvref_t<decltype(fields<T>)>>>::type;
+
+    /// Builds the datatype for a described type once, on first use.
+    template <described_type T>
+    struct DescribedType {
+        operator MPI_Datatype() const {
+            static MPI_Datatype const t = _make(std::make_index_sequence<std::tuple_size_v<decltype(fields<T>)>>{});
+            return t;
+        }
+
+      private:
+        template <std::size_t... Is>
+        static auto _make(std::index_sequence<Is...>) -> MPI_Datatype
+        {
+            union _storage {
+                T t;
+                _storage() {}
+            } storage;
+
+            auto offset = [&](auto member) -> MPI_Aint {
+                return reinterpret_cast<char const*>(std::addressof(storage.t.*member))
+                    - reinterpret_cast<char const*>(std::addressof(storage.t));
+            };
+
+            int const lengths[] = {
+                int(sizeof(_field_t<T, Is>) / sizeof(std::remove_all_extents_t<_field_t<T, Is>>))...
+            };
+            MPI_Aint const offsets[] = { offset(std::get<Is>(fields<T>))... };
+            MPI_Datatype const types[] = { type<std::remove_all_extents_t<_field_t<T, Is>>>... };
+            return make_struct_type(lengths, offsets, types, sizeof(T));
+        }
+    };
+
+    /// A committed 16-bit datatype shared by every half_float type. It is a
+    /// derived type, so builtin MPI_Ops reject it rather than misinterpret it.
+    auto half_type(
+        sloc_t = sloc_t::current()) noexcept    //!< debugging location
+        -> MPI_Datatype;
+
+    /// 16-bit floating point types, e.g., std::float16_t, std::bfloat16_t,
+    /// _Float16, or a user type that converts to and from float.
+    template <class T>
+    concept half_float = sizeof(T) == 2
+        and std::is_trivially_copyable_v<T>
+        and not std::integral<T>
+        and not std::is_enum_v<T>
+        and not user_defined_type<T>
+        and not described_type<T>
+        and requires (T t, float f) {
+            static_cast<float>(t);
+            static_cast<T>(f);
+        };
+
+    template <half_float T>
+    struct HalfType {
+        operator MPI_Datatype() const {
+            return half_type();
+        }
+    };
+
     template <user_defined_type T> DeferredType<T> const type<T>{};
+    template <half_float T> HalfType<T> const type<T>{};
+    template <described_type T> DescribedType<T> const type<T>{};
 
     template <class T>
     concept trivially_copyable = std::is_trivially_copyable_v<T>;
@@ -104,7 +222,7 @@ namespace tiny_mpi
 
     struct max {
         constexpr auto operator()(auto a, auto b) noexcept {
-            return std::min(a, b);
+            return std::max(a, b);
         }
     };
 
@@ -132,6 +250,160 @@ namespace tiny_mpi
     template <class T>
     concept reduction_op = std::same_as<decltype(op<T>), const MPI_Op>;
 
+    /// A stateless callable that combines two `T`s, which is registered as a
+    /// custom MPI_Op the first time it is used for `T`.
+    ///
+    ///     struct min_loc {
+    ///         static constexpr bool commutative = true;
+    ///         auto operator()(value_loc a, value_loc b) const { ... }
+    ///     };
+    ///     wait(tiny_mpi::allreduce(v, min_loc{}));
+    template <class F, class T>
+    concept _combines = std::default_initializable<F>
+        and std::regular_invocable<F&, T const&, T const&>
+        and std::convertible_to<std::invoke_result_t<F&, T const&, T const&>, T>;
+
+    template <class F, class T>
+    concept custom_reduction = not reduction_op<F> and _combines<F, T>;
+
+    /// Types whose `type<T>` is a derived datatype, which builtin MPI_Ops do not
+    /// apply to.
+    template <class T>
+    concept derived_type = user_defined_type<T> or described_type<T> or half_float<T>;
+
+    /// The fp32 functor used to combine half_float values for a builtin F.
+    template <class F> struct _float_op {};
+    template <> struct _float_op<min> { using type = min; };
+    template <> struct _float_op<max> { using type = max; };
+    template <class T> struct _float_op<std::plus<T>> { using type = std::plus<>; };
+    template <class T> struct _float_op<std::multiplies<T>> { using type = std::multiplies<>; };
+
+    /// Builtin functors over derived types apply F elementwise through a custom
+    /// op, except for half_float types, which accumulate in fp32.
+    template <class F, class T>
+    concept reduction_for = (reduction_op<F> and not derived_type<T>)
+        or (half_float<T> and requires { typename _float_op<F>::type; })
+        or (reduction_op<F> and not half_float<T> and _combines<F, T>)
+        or custom_reduction<F, T>;
+
+    /// Custom reductions are non-commutative unless F has a `static constexpr
+    /// bool commutative = true` member, or this variable is specialized.
+    /// Builtin functors are commutative.
+    template <class F>
+    inline constexpr bool is_commutative = reduction_op<F>
+        or requires { requires bool(F::commutative); };
+
+    /// Creates an MPI_Op and releases it in fini().
+    auto make_op(
+        MPI_User_function* f,                   //!< reduction function
+        bool commutative,                       //!< commutativity
+        sloc_t = sloc_t::current()) noexcept    //!< debugging location
+        -> MPI_Op;
+
+    /// A custom reduction that also provides a bulk `f(in, inout, n)` overload,
+    /// e.g., one implemented with the kernels in tiny_mpi/kernels.hpp.
+    template <class F, class T>
+    concept bulk_reduction = std::invocable<F&, T const*, T*, std::size_t>;
+
+    /// The MPI user function for a custom reduction, `inout[i] = f(in[i], inout[i])`.
+    template <class F, class T>
+    void _user_reduce(void* in, void* inout, int* n, MPI_Datatype*)
+    {
+        F f{};
+        T const* a = static_cast<T const*>(in);
+        T* b = static_cast<T*>(inout);
+        if constexpr (bulk_reduction<F, T>) {
+            f(a, b, std::size_t(*n));
+        }
+        else {
+            for (int i = 0, e = *n; i < e; ++i) {
+                b[i] = f(a[i], b[i]);
+            }
+        }
+    }
+
+    /// The cached MPI_Op for reducing `T`s with `F`.
+    template <class F, class T> requires _combines<F, T>
+    auto user_op() -> MPI_Op {
+        static MPI_Op const o = make_op(&_user_reduce<F, T>, is_commutative<F>);
+        return o;
+    }
+
+    /// Reduces half_float values with the builtin functor F, accumulating in
+    /// fp32.
+    ///
+    /// Values travel as 16 bits, half the volume of float, and every combine
+    /// step widens to fp32, applies F (vectorized in bulk), and rounds back
+    /// once. Rounding therefore happens once per reduction-tree hop rather than
+    /// per element operation in 16-bit arithmetic.
+    template <class F, half_float T>
+    struct _widened
+    {
+        using _fp32_t = typename _float_op<F>::type;
+
+        static constexpr bool commutative = true;
+
+        auto operator()(T const& a, T const& b) const -> T {
+            return static_cast<T>(_fp32_t{}(static_cast<float>(a), static_cast<float>(b)));
+        }
+
+        void operator()(T const* in, T* inout, std::size_t n) const {
+            constexpr std::size_t chunk = 256;
+            float a[chunk], b[chunk];
+            for (std::size_t i = 0; i < n; i += chunk) {
+                std::size_t m = std::min(chunk, n - i);
+                for (std::size_t j = 0; j < m; ++j) {
+                    a[j] = static_cast<float>(in[i + j]);
+                    b[j] = static_cast<float>(inout[i + j]);
+                }
+
+                if constexpr (std::same_as<_fp32_t, std::plus<>>) {
+                    kernels::sum(a, b, m);
+                }
+                else if constexpr (std::same_as<_fp32_t, std::multiplies<>>) {
+                    kernels::prod(a, b, m);
+                }
+                else if constexpr (std::same_as<_fp32_t, min>) {
+                    kernels::min(a, b, m);
+                }
+                else {
+                    kernels::max(a, b, m);
+                }
+
+                for (std::size_t j = 0; j < m; ++j) {
+                    inout[i + j] = static_cast<T>(b[j]);
+                }
+            }
+        }
+    };
+
+    /// Maps a reduction functor to its builtin or custom MPI_Op. Builtin functors
+    /// over derived types use custom ops, fp32-accumulating for half_float types.
+    template <class F, class T> requires reduction_for<F, T>
+    auto mpi_op() -> MPI_Op {
+        if constexpr (half_float<T> and reduction_op<F>) {
+            return user_op<_widened<F, T>, T>();
+        }
+        else if constexpr (reduction_op<F> and not derived_type<T>) {
+            return op<F>;
+        }
+        else {
+            return user_op<F, T>();
+        }
+    }
+
+    /// The default op of the MPI_Op overloads: MPI_SUM, or the fp32-accumulating
+    /// sum for half_float types, which MPI_SUM does not apply to.
+    template <class T>
+    auto sum_op() -> MPI_Op {
+        if constexpr (half_float<T>) {
+            return mpi_op<std::plus<T>, T>();
+        }
+        else {
+            return MPI_SUM;
+        }
+    }
+
     /// Simple wrappers to check initialized and finalized.
     bool initialized(
         sloc_t = sloc_t::current()) noexcept;   //!< debugging location
@@ -160,14 +432,6 @@ namespace tiny_mpi
         int e,                                  //!< error code
         sloc_t = sloc_t::current()) noexcept;   //!< debugging location
 
-    /// Returns the count for a matching message.
-    [[nodiscard]]
-    auto probe(
-        rank_t source,                               //!< source rank
-        MPI_Datatype type,                           //!< type for count
-        tag_t tag = 0,                               //!< user defined tag
-        sloc_t = sloc_t::current()) noexcept -> int; //!< debugging location
-
     /// Blocks until all of the requests are complete, ignores status.
     void wait(
         std::span<request_t> reqs,              //!< requests
@@ -192,36 +456,290 @@ namespace tiny_mpi
     /// Helper macro for check
 #define tiny_mpi_check_op(op) #op, (op)
 
+    /// Helper macro for check on calls that take a large_count, selects the
+    /// MPI 4 `_c` variant when available.
+#if MPI_VERSION >= 4
+#define tiny_mpi_large_op(op) #op "_c", (op##_c)
+#else
+#define tiny_mpi_large_op(op) #op, (op)
+#endif
+
+    /// A count and datatype that MPI accepts for some number of elements.
+    struct large_count
+    {
+#if MPI_VERSION >= 4
+        count_t n;
+#else
+        int n;
+#endif
+        MPI_Datatype type;
+    };
+
+    /// Returns a cached, committed contiguous datatype of `n` elements of
+    /// `type`, for counts that do not fit in an int. It is freed in fini().
+    auto large_type(
+        MPI_Datatype type,                      //!< element type
+        count_t n,                              //!< number of elements
+        sloc_t = sloc_t::current()) noexcept    //!< debugging location
+        -> MPI_Datatype;
+
+    /// Maps `n` elements of `type` to a count for a tiny_mpi_large_op() call.
+    ///
+    /// MPI 4 passes the count through to the `_c` variant. Older libraries send
+    /// counts above INT_MAX as a single element of a large_type().
+    [[nodiscard]]
+    inline auto large(
+        MPI_Datatype type,                      //!< element type
+        count_t n,                              //!< number of elements
+        sloc_t sloc = sloc_t::current()) noexcept -> large_count
+    {
+#if MPI_VERSION >= 4
+        return { n, type };
+#else
+        if (n <= std::numeric_limits<int>::max()) [[likely]] {
+            return { int(n), type };
+        }
+        return { 1, large_type(type, n, sloc) };
+#endif
+    }
+
+    /// Calls `f(offset, m)` for consecutive chunks of at most INT_MAX of `n`
+    /// elements, and once for `n == 0`.
+    ///
+    /// Reductions are split this way rather than sent as a large_type(),
+    /// because builtin MPI_Ops only apply to predefined datatypes and user
+    /// functions take an int length.
+    void _for_chunks(count_t n, auto&& f)
+    {
+        constexpr count_t chunk = std::numeric_limits<int>::max();
+        count_t i = 0;
+        do {
+            f(i, int(std::min(chunk, n - i)));
+            i += chunk;
+        } while (i < n);
+    }
+
+    /// Posts `post(offset, m)` for each chunk of `n` elements and returns the
+    /// request for the last one. Earlier chunks are complete on return.
+    auto _chunked(count_t n, auto&& post, sloc_t sloc) -> request_t
+    {
+        if (n <= std::numeric_limits<int>::max()) [[likely]] {
+            return post(count_t(0), int(n));
+        }
+
+        std::vector<request_t> rs;
+        _for_chunks(n, [&](count_t i, int m) { rs.push_back(post(i, m)); });
+        request_t last = rs.back();
+        rs.pop_back();
+        wait(rs, sloc);
+        return last;
+    }
+
+    /// An MPI_Comm with its rank and size cached.
+    ///
+    /// Communicators created through split(), split_type(), dup(), cart(), or
+    /// cart_sub() are owned and freed on destruction. Communicators constructed
+    /// directly from an MPI_Comm are borrowed and never freed.
+    class communicator
+    {
+        MPI_Comm _comm = MPI_COMM_NULL;
+        rank_t _rank = MPI_PROC_NULL;
+        rank_t _n_ranks = 0;
+        bool _owned = false;
+
+      public:
+        communicator() = default;
+
+        /// Borrow an existing communicator.
+        explicit communicator(
+            MPI_Comm comm,
+            sloc_t = sloc_t::current()) noexcept;   //!< debugging location
+
+        communicator(communicator&& b) noexcept
+                : _comm(std::exchange(b._comm, MPI_COMM_NULL))
+                , _rank(std::exchange(b._rank, MPI_PROC_NULL))
+                , _n_ranks(std::exchange(b._n_ranks, 0))
+                , _owned(std::exchange(b._owned, false))
+        {
+        }
+
+        auto operator=(communicator&& b) noexcept -> communicator& {
+            if (this != &b) {
+                _free();
+                _comm = std::exchange(b._comm, MPI_COMM_NULL);
+                _rank = std::exchange(b._rank, MPI_PROC_NULL);
+                _n_ranks = std::exchange(b._n_ranks, 0);
+                _owned = std::exchange(b._owned, false);
+            }
+            return *this;
+        }
+
+        ~communicator() {
+            _free();
+        }
+
+        operator MPI_Comm() const noexcept {
+            return _comm;
+        }
+
+        explicit operator bool() const noexcept {
+            return _comm != MPI_COMM_NULL;
+        }
+
+        [[nodiscard]]
+        auto rank() const noexcept -> rank_t {
+            return _rank;
+        }
+
+        [[nodiscard]]
+        auto n_ranks() const noexcept -> rank_t {
+            return _n_ranks;
+        }
+
+        [[nodiscard]]
+        auto ranks() const noexcept {
+            return std::ranges::iota_view{0, _n_ranks};
+        }
+
+        /// MPI_Comm_split, ranks passing MPI_UNDEFINED get a null communicator.
+        [[nodiscard]]
+        auto split(
+            int color,                                          //!< group color
+            int key = 0,                                        //!< rank order
+            sloc_t = sloc_t::current()) const noexcept          //!< debugging location
+            -> communicator;
+
+        /// MPI_Comm_split_type, defaults to the node-local shared-memory group.
+        [[nodiscard]]
+        auto split_type(
+            int type = MPI_COMM_TYPE_SHARED,                    //!< split type
+            int key = 0,                                        //!< rank order
+            sloc_t = sloc_t::current()) const noexcept          //!< debugging location
+            -> communicator;
+
+        [[nodiscard]]
+        auto dup(
+            sloc_t = sloc_t::current()) const noexcept          //!< debugging location
+            -> communicator;
+
+        /// MPI_Cart_create, ranks left out of the grid get a null communicator.
+        [[nodiscard]]
+        auto cart(
+            std::span<int const> dims,                          //!< grid extents
+            std::span<int const> periods,                       //!< periodic flags
+            bool reorder = true,                                //!< allow reordering
+            sloc_t = sloc_t::current()) const noexcept          //!< debugging location
+            -> communicator;
+
+        /// MPI_Cart_sub, e.g., {1, 0} selects the row communicators of a 2-D grid.
+        [[nodiscard]]
+        auto cart_sub(
+            std::span<int const> remain,                        //!< kept dimensions
+            sloc_t = sloc_t::current()) const noexcept          //!< debugging location
+            -> communicator;
+
+        /// MPI_Cart_coords for `rank` in a cartesian communicator.
+        [[nodiscard]]
+        auto cart_coords(
+            rank_t rank,                                        //!< rank to query
+            sloc_t = sloc_t::current()) const noexcept          //!< debugging location
+            -> std::vector<int>;
+
+        /// MPI_Cart_shift, returns the {source, dest} pair.
+        [[nodiscard]]
+        auto cart_shift(
+            int dim,                                            //!< dimension
+            int displacement = 1,                               //!< shift distance
+            sloc_t = sloc_t::current()) const noexcept          //!< debugging location
+            -> std::pair<rank_t, rank_t>;
+
+        /// MPI_Dist_graph_create_adjacent, where this rank receives from
+        /// `sources` and sends to `destinations` in neighborhood collectives.
+        [[nodiscard]]
+        auto dist_graph(
+            std::span<rank_t const> sources,                    //!< in-neighbors
+            std::span<rank_t const> destinations,               //!< out-neighbors
+            bool reorder = false,                               //!< allow reordering
+            sloc_t = sloc_t::current()) const noexcept          //!< debugging location
+            -> communicator;
+
+        /// A symmetric distributed graph, e.g., the halo neighbors of a stencil.
+        [[nodiscard]]
+        auto dist_graph(
+            std::span<rank_t const> neighbors,                  //!< in- and out-neighbors
+            bool reorder = false,                               //!< allow reordering
+            sloc_t sloc = sloc_t::current()) const noexcept     //!< debugging location
+            -> communicator
+        {
+            return dist_graph(neighbors, neighbors, reorder, sloc);
+        }
+
+        /// MPI_Dist_graph_neighbors, returns the {sources, destinations} pair.
+        [[nodiscard]]
+        auto neighbors(
+            sloc_t = sloc_t::current()) const noexcept          //!< debugging location
+            -> std::pair<std::vector<rank_t>, std::vector<rank_t>>;
+
+        /// MPI_Dist_graph_neighbors_count, returns the {in, out} degrees.
+        [[nodiscard]]
+        auto degrees(
+            sloc_t = sloc_t::current()) const noexcept          //!< debugging location
+            -> std::pair<int, int>;
+
+        /// MPI_Group_translate_ranks, maps `ranks` of this communicator to
+        /// `other`, with MPI_UNDEFINED for ranks that are not in `other`.
+        [[nodiscard]]
+        auto translate(
+            std::span<rank_t const> ranks,                      //!< ranks in this communicator
+            communicator const& other,                          //!< target communicator
+            sloc_t = sloc_t::current()) const noexcept          //!< debugging location
+            -> std::vector<rank_t>;
+
+      private:
+        static auto _adopt(MPI_Comm comm, sloc_t sloc) noexcept -> communicator;
+
+        void _free() noexcept;
+    };
+
+    /// The cached MPI_COMM_WORLD communicator, populated by init(). Must not be
+    /// called before init(), the rank and size are cached on the first call.
+    [[nodiscard]]
+    auto world() noexcept -> communicator const&;
+
     [[nodiscard]]
-    static inline auto rank(sloc_t sloc = sloc_t::current())
+    static inline auto rank(
+        communicator const& comm = world(),
+        sloc_t = sloc_t::current()) noexcept
         -> rank_t
     {
-        rank_t rank;
-        check(sloc, tiny_mpi_check_op(MPI_Comm_rank), MPI_COMM_WORLD, &rank);
-        return rank;
+        return comm.rank();
     }
 
     [[nodiscard]]
-    static inline auto n_ranks(sloc_t sloc = sloc_t::current())
+    static inline auto n_ranks(
+        communicator const& comm = world(),
+        sloc_t = sloc_t::current()) noexcept
         -> rank_t
     {
-        rank_t n_ranks;
-        check(sloc, tiny_mpi_check_op(MPI_Comm_size), MPI_COMM_WORLD, &n_ranks);
-        return n_ranks;
+        return comm.n_ranks();
     }
 
     [[nodiscard]]
-    static inline auto ranks(sloc_t sloc = sloc_t::current())
+    static inline auto ranks(
+        communicator const& comm = world(),
+        sloc_t = sloc_t::current()) noexcept
     {
-        return std::ranges::iota_view{0, n_ranks(std::move(sloc))};
+        return comm.ranks();
     }
 
     [[nodiscard]]
-    static inline auto barrier(sloc_t sloc = sloc_t::current())
+    static inline auto barrier(
+        communicator const& comm = world(),
+        sloc_t sloc = sloc_t::current())
         -> request_t
     {
         request_t r;
-        check(sloc, tiny_mpi_check_op(MPI_Ibarrier), MPI_COMM_WORLD, &r);
+        check(sloc, tiny_mpi_check_op(MPI_Ibarrier), comm, &r);
         return r;
     }
 
@@ -230,14 +748,33 @@ namespace tiny_mpi
         wait(rs);
     }
 
+    /// Returns the number of `type` elements in a received or probed message.
+    [[nodiscard]]
+    auto get_count(
+        MPI_Status const& status,                    //!< from a receive or probe
+        MPI_Datatype type,                           //!< type for count
+        sloc_t = sloc_t::current()) noexcept         //!< debugging location
+        -> count_t;
+
+    /// Returns the count for a matching message.
+    [[nodiscard]]
+    auto probe(
+        rank_t source,                               //!< source rank
+        MPI_Datatype type,                           //!< type for count
+        tag_t tag = 0,                               //!< user defined tag
+        communicator const& comm = world(),          //!< communicator
+        sloc_t = sloc_t::current()) noexcept         //!< debugging location
+        -> count_t;
+
     template <mpi_typed T>
     [[nodiscard]]
     auto probe(
         rank_t source,
         tag_t tag = 0,
-        sloc_t sloc = sloc_t::current()) -> int
+        communicator const& comm = world(),
+        sloc_t sloc = sloc_t::current()) -> count_t
     {
-        return probe(source, type<T>, tag, sloc);
+        return probe(source, type<T>, tag, comm, sloc);
     }
 
     template <trivially_copyable T>
@@ -245,22 +782,105 @@ namespace tiny_mpi
     auto probe(
         rank_t source,
         tag_t tag = 0,
-        sloc_t sloc = sloc_t::current()) -> int
+        communicator const& comm = world(),
+        sloc_t sloc = sloc_t::current()) -> count_t
+    {
+        return probe(source, type<char>, tag, comm, sloc) / sizeof(T);
+    }
+
+    /// Returns a cached, committed datatype selecting `extents` elements of
+    /// `type` at the given element `strides`, outermost dimension first.
+    ///
+    /// Each dimension nests an MPI_Type_create_hvector with a byte stride, so
+    /// strides need not fit in an int. The datatype is freed in fini().
+    auto strided_type(
+        MPI_Datatype type,                      //!< element type
+        std::span<int const> extents,           //!< elements per dimension
+        std::span<MPI_Aint const> strides,      //!< element stride per dimension
+        sloc_t = sloc_t::current()) noexcept    //!< debugging location
+        -> MPI_Datatype;
+
+    /// A non-contiguous N-dimensional view that is transferred without packing.
+    template <class T, std::size_t N = 1>
+    struct strided_span
+    {
+        T* data;
+        std::array<int, N> extents;             //!< elements per dimension
+        std::array<MPI_Aint, N> strides;        //!< element stride per dimension
+
+        [[nodiscard]]
+        auto mpi_type(sloc_t sloc = sloc_t::current()) const noexcept -> MPI_Datatype {
+            return strided_type(type<std::remove_const_t<T>>, extents, strides, sloc);
+        }
+    };
+
+    /// A strided view of `n` elements, e.g., the column of a row-major matrix.
+    template <mpi_typed T>
+    [[nodiscard]]
+    constexpr auto strided(T* data, int n, MPI_Aint stride) noexcept
+        -> strided_span<T, 1>
+    {
+        return { data, { n }, { stride } };
+    }
+
+    template <mpi_typed T>
+    [[nodiscard]]
+    constexpr auto strided(T const* data, int n, MPI_Aint stride) noexcept
+        -> strided_span<T const, 1>
+    {
+        return { data, { n }, { stride } };
+    }
+
+    /// The `subsizes` block at `starts` within a row-major array of `sizes`, e.g.,
+    /// a face of a 3-D grid.
+    template <class T, std::size_t N>
+    [[nodiscard]]
+    constexpr auto subarray(
+        T* base,
+        std::array<int, N> const& sizes,
+        std::array<int, N> const& subsizes,
+        std::array<int, N> const& starts) noexcept
+        -> strided_span<T, N>
+    {
+        strided_span<T, N> out { base, subsizes, {} };
+        MPI_Aint stride = 1;
+        for (std::size_t i = N; i-- != 0;) {
+            out.strides[i] = stride;
+            out.data += starts[i] * stride;
+            stride *= sizes[i];
+        }
+        return out;
+    }
+
+#ifdef __cpp_lib_mdspan
+    /// Views any strided std::mdspan layout (right, left, or stride).
+    template <class T, class Extents, class Layout, class Accessor>
+    [[nodiscard]]
+    constexpr auto strided(std::mdspan<T, Extents, Layout, Accessor> const& m) noexcept
+        -> strided_span<T, Extents::rank()>
     {
-        return probe(source, type<char>, tag, sloc) / sizeof(T);
+        strided_span<T, Extents::rank()> out { m.data_handle(), {}, {} };
+        for (std::size_t i = 0; i < Extents::rank(); ++i) {
+            out.extents[i] = m.extent(i);
+            out.strides[i] = m.stride(i);
+        }
+        return out;
     }
+#endif
 
     template <mpi_typed T>
     [[nodiscard]]
     auto send(
         const T* from,
-        int n,
+        count_t n,
         rank_t to_rank,
         tag_t tag = 0,
+        communicator const& comm = world(),
         sloc_t sloc = sloc_t::current()) -> request_t
     {
+        auto const [m, t] = large(type<T>, n, sloc);
         request_t r;
-        check(sloc, tiny_mpi_check_op(MPI_Isend), from, n, type<T>, to_rank, tag, MPI_COMM_WORLD, &r);
+        check(sloc, tiny_mpi_large_op(MPI_Isend), from, m, t, to_rank, tag, comm, &r);
         return r;
     }
 
@@ -268,13 +888,15 @@ namespace tiny_mpi
     [[nodiscard]]
     auto send(
         const T* from,
-        int n,
+        count_t n,
         rank_t to_rank,
         tag_t tag = 0,
+        communicator const& comm = world(),
         sloc_t sloc = sloc_t::current()) -> request_t
     {
+        auto const [m, t] = large(type<char>, count_t(sizeof(T)) * n, sloc);
         request_t r;
-        check(sloc, tiny_mpi_check_op(MPI_Isend), from, sizeof(T) * n, type<char>, to_rank, tag, MPI_COMM_WORLD, &r);
+        check(sloc, tiny_mpi_large_op(MPI_Isend), from, m, t, to_rank, tag, comm, &r);
         return r;
     }
 
@@ -283,6 +905,7 @@ namespace tiny_mpi
         std::ranges::contiguous_range auto const& from,
         rank_t to_rank,
         tag_t tag = 0,
+        communicator const& comm = world(),
         sloc_t sloc = sloc_t::current()) -> request_t
     {
         return send(
@@ -290,6 +913,7 @@ namespace tiny_mpi
             std::ranges::size(from),
             to_rank,
             tag,
+            comm,
             std::move(sloc));
     }
 
@@ -297,13 +921,15 @@ namespace tiny_mpi
     [[nodiscard]]
     auto recv(
         T* to,
-        int n,
+        count_t n,
         rank_t from_rank,
         tag_t tag = 0,
+        communicator const& comm = world(),
         sloc_t sloc = sloc_t::current()) -> request_t
     {
+        auto const [m, t] = large(type<T>, n, sloc);
         request_t r;
-        check(sloc, tiny_mpi_check_op(MPI_Irecv), to, n, type<T>, from_rank, tag, MPI_COMM_WORLD, &r);
+        check(sloc, tiny_mpi_large_op(MPI_Irecv), to, m, t, from_rank, tag, comm, &r);
         return r;
     }
 
@@ -311,13 +937,15 @@ namespace tiny_mpi
     [[nodiscard]]
     auto recv(
         T* to,
-        int n,
+        count_t n,
         rank_t from_rank,
         tag_t tag = 0,
+        communicator const& comm = world(),
         sloc_t sloc = sloc_t::current()) -> request_t
     {
+        auto const [m, t] = large(type<char>, count_t(sizeof(T)) * n, sloc);
         request_t r;
-        check(sloc, tiny_mpi_check_op(MPI_Irecv), to, sizeof(T) * n, type<char>, from_rank, tag, MPI_COMM_WORLD, &r);
+        check(sloc, tiny_mpi_large_op(MPI_Irecv), to, m, t, from_rank, tag, comm, &r);
         return r;
     }
 
@@ -326,6 +954,7 @@ namespace tiny_mpi
         std::ranges::contiguous_range auto& to,
         rank_t from_rank,
         tag_t tag = 0,
+        communicator const& comm = world(),
         sloc_t sloc = sloc_t::current()) -> request_t
     {
         return recv(
@@ -333,39 +962,103 @@ namespace tiny_mpi
             std::ranges::size(to),
             from_rank,
             tag,
+            comm,
             std::move(sloc));
     }
 
+    template <class T, std::size_t N>
+    [[nodiscard]]
+    auto send(
+        strided_span<T, N> const& from,
+        rank_t to_rank,
+        tag_t tag = 0,
+        communicator const& comm = world(),
+        sloc_t sloc = sloc_t::current()) -> request_t
+        requires mpi_typed<std::remove_const_t<T>>
+    {
+        request_t r;
+        check(sloc, tiny_mpi_check_op(MPI_Isend), from.data, 1, from.mpi_type(sloc), to_rank, tag, comm, &r);
+        return r;
+    }
+
+    template <class T, std::size_t N>
+    [[nodiscard]]
+    auto recv(
+        strided_span<T, N> const& to,
+        rank_t from_rank,
+        tag_t tag = 0,
+        communicator const& comm = world(),
+        sloc_t sloc = sloc_t::current()) -> request_t
+        requires mpi_typed<T>
+    {
+        request_t r;
+        check(sloc, tiny_mpi_check_op(MPI_Irecv), to.data, 1, to.mpi_type(sloc), from_rank, tag, comm, &r);
+        return r;
+    }
+
+#ifdef __cpp_lib_mdspan
+    template <class T, class Extents, class Layout, class Accessor>
+    [[nodiscard]]
+    auto send(
+        std::mdspan<T, Extents, Layout, Accessor> const& from,
+        rank_t to_rank,
+        tag_t tag = 0,
+        communicator const& comm = world(),
+        sloc_t sloc = sloc_t::current()) -> request_t
+        requires mpi_typed<std::remove_const_t<T>>
+    {
+        return send(strided(from), to_rank, tag, comm, sloc);
+    }
+
+    template <class T, class Extents, class Layout, class Accessor>
+    [[nodiscard]]
+    auto recv(
+        std::mdspan<T, Extents, Layout, Accessor> const& to,
+        rank_t from_rank,
+        tag_t tag = 0,
+        communicator const& comm = world(),
+        sloc_t sloc = sloc_t::current()) -> request_t
+        requires mpi_typed<T>
+    {
+        return recv(strided(to), from_rank, tag, comm, sloc);
+    }
+#endif
+
     template <mpi_typed T>
     [[nodiscard]]
     auto allreduce(
         T* buffer,
-        int n,
-        MPI_Op op = MPI_SUM,
+        count_t n,
+        MPI_Op op = sum_op<T>(),
+        communicator const& comm = world(),
         sloc_t sloc = sloc_t::current()) -> request_t
     {
-        request_t r;
-        check(sloc, tiny_mpi_check_op(MPI_Iallreduce), MPI_IN_PLACE, buffer, n, type<T>, op, MPI_COMM_WORLD, &r);
-        return r;
+        return _chunked(n, [&](count_t i, int m) {
+            request_t r;
+            check(sloc, tiny_mpi_check_op(MPI_Iallreduce), MPI_IN_PLACE, buffer + i, m, type<T>, op, comm, &r);
+            return r;
+        }, sloc);
     }
 
 
-    template <mpi_typed T, reduction_op Op>
+    template <mpi_typed T, reduction_for<T> Op>
     [[nodiscard]]
     auto allreduce(
         T* v,
-        int n,
+        count_t n,
         Op,
+        communicator const& comm = world(),
         sloc_t sloc = sloc_t::current()) -> request_t
     {
-        return allreduce(v, n, op<Op>, sloc);
+        return allreduce(v, n, mpi_op<Op, T>(), comm, sloc);
     }
 
     template <std::ranges::contiguous_range Range>
     [[nodiscard]]
     auto allreduce(
         Range& v,
-        MPI_Op op = MPI_SUM,
+        MPI_Op op = sum_op<std::ranges::range_value_t<Range>>(),
+        communicator const& comm = world(),
         sloc_t sloc = sloc_t::current()) -> request_t
         requires mpi_typed<std::ranges::range_value_t<Range>>
     {
@@ -373,29 +1066,33 @@ namespace tiny_mpi
             std::ranges::data(v),
             std::ranges::size(v),
             op,
+            comm,
             sloc);
     }
 
-    template <std::ranges::contiguous_range Range, reduction_op Op>
+    template <std::ranges::contiguous_range Range, class Op>
     [[nodiscard]]
     auto allreduce(
         Range& v,
         Op,
+        communicator const& comm = world(),
         sloc_t sloc = sloc_t::current()) -> request_t
         requires mpi_typed<std::ranges::range_value_t<Range>>
+            and reduction_for<Op, std::ranges::range_value_t<Range>>
     {
-        return allreduce(v, op<Op>, sloc);
+        return allreduce(v, mpi_op<Op, std::ranges::range_value_t<Range>>(), comm, sloc);
     }
 
     template <mpi_typed T>
     [[nodiscard]]
     auto allreduce(
         T& value,
-        MPI_Op op = MPI_SUM,
+        MPI_Op op = sum_op<T>(),
+        communicator const& comm = world(),
         sloc_t sloc = sloc_t::current()) -> request_t
     {
         request_t r;
-        check(sloc, tiny_mpi_check_op(MPI_Iallreduce), MPI_IN_PLACE, std::addressof(value), 1, type<T>, op, MPI_COMM_WORLD, &r);
+        check(sloc, tiny_mpi_check_op(MPI_Iallreduce), MPI_IN_PLACE, std::addressof(value), 1, type<T>, op, comm, &r);
         return r;
     }
 
@@ -403,20 +1100,22 @@ namespace tiny_mpi
     [[nodiscard]]
     auto allgather(
         T* values,
-        int count,
+        count_t count,
+        communicator const& comm = world(),
         sloc_t sloc = sloc_t::current()) -> request_t
     {
+        auto const [m, t] = large(type<T>, count, sloc);
         request_t r;
         check(
             sloc,
-            tiny_mpi_check_op(MPI_Iallgather),
+            tiny_mpi_large_op(MPI_Iallgather),
             MPI_IN_PLACE,
             0,
             MPI_DATATYPE_NULL,
             values,
-            count,
-            type<T>,
-            MPI_COMM_WORLD,
+            m,
+            t,
+            comm,
             &r);
         return r;
     }
@@ -425,10 +1124,11 @@ namespace tiny_mpi
     [[nodiscard]]
     auto allgather(
         Range& values,
+        communicator const& comm = world(),
         sloc_t sloc = sloc_t::current()) -> request_t
         requires mpi_typed<std::ranges::range_value_t<Range>>
     {
-        return allgather(std::ranges::data(values), 1, sloc);
+        return allgather(std::ranges::data(values), 1, comm, sloc);
     }
 
     template <mpi_typed T>
@@ -437,6 +1137,7 @@ namespace tiny_mpi
         T* values,
         std::span<int const> counts,
         std::span<int const> offsets,
+        communicator const& comm = world(),
         sloc_t sloc = sloc_t::current()) -> request_t
     {
         request_t r;
@@ -450,7 +1151,7 @@ namespace tiny_mpi
             data(counts),
             data(offsets),
             type<T>,
-            MPI_COMM_WORLD,
+            comm,
             &r);
         return r;
     }
@@ -461,10 +1162,1518 @@ namespace tiny_mpi
         Range& values,
         std::span<int const> counts,
         std::span<int const> offsets,
+        communicator const& comm = world(),
+        sloc_t sloc = sloc_t::current()) -> request_t
+        requires mpi_typed<std::ranges::range_value_t<Range>>
+    {
+        return allgather(std::ranges::data(values), counts, offsets, comm, sloc);
+    }
+
+    template <mpi_typed T>
+    [[nodiscard]]
+    auto bcast(
+        T* buffer,
+        count_t n,
+        rank_t root = 0,
+        communicator const& comm = world(),
+        sloc_t sloc = sloc_t::current()) -> request_t
+    {
+        auto const [m, t] = large(type<T>, n, sloc);
+        request_t r;
+        check(sloc, tiny_mpi_large_op(MPI_Ibcast), buffer, m, t, root, comm, &r);
+        return r;
+    }
+
+    template <std::ranges::contiguous_range Range>
+    [[nodiscard]]
+    auto bcast(
+        Range& v,
+        rank_t root = 0,
+        communicator const& comm = world(),
         sloc_t sloc = sloc_t::current()) -> request_t
         requires mpi_typed<std::ranges::range_value_t<Range>>
     {
-        return allgather(std::ranges::data(values), counts, offsets, sloc);
+        return bcast(std::ranges::data(v), std::ranges::size(v), root, comm, sloc);
+    }
+
+    template <mpi_typed T>
+    [[nodiscard]]
+    auto bcast(
+        T& value,
+        rank_t root = 0,
+        communicator const& comm = world(),
+        sloc_t sloc = sloc_t::current()) -> request_t
+    {
+        return bcast(std::addressof(value), 1, root, comm, sloc);
+    }
+
+    /// Reduces in place into `buffer` on `root`, the other buffers are unchanged.
+    template <mpi_typed T>
+    [[nodiscard]]
+    auto reduce(
+        T* buffer,
+        count_t n,
+        MPI_Op op = sum_op<T>(),
+        rank_t root = 0,
+        communicator const& comm = world(),
+        sloc_t sloc = sloc_t::current()) -> request_t
+    {
+        return _chunked(n, [&](count_t i, int m) {
+            request_t r;
+            if (comm.rank() == root) {
+                check(sloc, tiny_mpi_check_op(MPI_Ireduce), MPI_IN_PLACE, buffer + i, m, type<T>, op, root, comm, &r);
+            }
+            else {
+                check(sloc, tiny_mpi_check_op(MPI_Ireduce), buffer + i, nullptr, m, type<T>, op, root, comm, &r);
+            }
+            return r;
+        }, sloc);
+    }
+
+    template <mpi_typed T, reduction_for<T> Op>
+    [[nodiscard]]
+    auto reduce(
+        T* v,
+        count_t n,
+        Op,
+        rank_t root = 0,
+        communicator const& comm = world(),
+        sloc_t sloc = sloc_t::current()) -> request_t
+    {
+        return reduce(v, n, mpi_op<Op, T>(), root, comm, sloc);
+    }
+
+    template <std::ranges::contiguous_range Range>
+    [[nodiscard]]
+    auto reduce(
+        Range& v,
+        MPI_Op op = sum_op<std::ranges::range_value_t<Range>>(),
+        rank_t root = 0,
+        communicator const& comm = world(),
+        sloc_t sloc = sloc_t::current()) -> request_t
+        requires mpi_typed<std::ranges::range_value_t<Range>>
+    {
+        return reduce(
+            std::ranges::data(v),
+            std::ranges::size(v),
+            op,
+            root,
+            comm,
+            sloc);
+    }
+
+    template <std::ranges::contiguous_range Range, class Op>
+    [[nodiscard]]
+    auto reduce(
+        Range& v,
+        Op,
+        rank_t root = 0,
+        communicator const& comm = world(),
+        sloc_t sloc = sloc_t::current()) -> request_t
+        requires mpi_typed<std::ranges::range_value_t<Range>>
+            and reduction_for<Op, std::ranges::range_value_t<Range>>
+    {
+        return reduce(v, mpi_op<Op, std::ranges::range_value_t<Range>>(), root, comm, sloc);
+    }
+
+    template <mpi_typed T>
+    [[nodiscard]]
+    auto reduce(
+        T& value,
+        MPI_Op op = sum_op<T>(),
+        rank_t root = 0,
+        communicator const& comm = world(),
+        sloc_t sloc = sloc_t::current()) -> request_t
+    {
+        return reduce(std::addressof(value), 1, op, root, comm, sloc);
+    }
+
+    /// Gathers in place like allgather(), each rank contributes the `count`
+    /// elements at `values + rank * count` and only `root` receives.
+    template <mpi_typed T>
+    [[nodiscard]]
+    auto gather(
+        T* values,
+        count_t count,
+        rank_t root = 0,
+        communicator const& comm = world(),
+        sloc_t sloc = sloc_t::current()) -> request_t
+    {
+        auto const [m, t] = large(type<T>, count, sloc);
+        request_t r;
+        if (comm.rank() == root) {
+            check(
+                sloc,
+                tiny_mpi_large_op(MPI_Igather),
+                MPI_IN_PLACE,
+                0,
+                MPI_DATATYPE_NULL,
+                values,
+                m,
+                t,
+                root,
+                comm,
+                &r);
+        }
+        else {
+            check(
+                sloc,
+                tiny_mpi_large_op(MPI_Igather),
+                values + comm.rank() * count,
+                m,
+                t,
+                nullptr,
+                0,
+                MPI_DATATYPE_NULL,
+                root,
+                comm,
+                &r);
+        }
+        return r;
+    }
+
+    template <std::ranges::contiguous_range Range>
+    [[nodiscard]]
+    auto gather(
+        Range& values,
+        rank_t root = 0,
+        communicator const& comm = world(),
+        sloc_t sloc = sloc_t::current()) -> request_t
+        requires mpi_typed<std::ranges::range_value_t<Range>>
+    {
+        return gather(std::ranges::data(values), 1, root, comm, sloc);
+    }
+
+    /// Gathers in place like allgather(), each rank contributes the
+    /// `counts[rank]` elements at `values + offsets[rank]`.
+    template <mpi_typed T>
+    [[nodiscard]]
+    auto gather(
+        T* values,
+        std::span<int const> counts,
+        std::span<int const> offsets,
+        rank_t root = 0,
+        communicator const& comm = world(),
+        sloc_t sloc = sloc_t::current()) -> request_t
+    {
+        request_t r;
+        if (comm.rank() == root) {
+            check(
+                sloc,
+                tiny_mpi_check_op(MPI_Igatherv),
+                MPI_IN_PLACE,
+                0,
+                MPI_DATATYPE_NULL,
+                values,
+                data(counts),
+                data(offsets),
+                type<T>,
+                root,
+                comm,
+                &r);
+        }
+        else {
+            check(
+                sloc,
+                tiny_mpi_check_op(MPI_Igatherv),
+                values + offsets[comm.rank()],
+                counts[comm.rank()],
+                type<T>,
+                nullptr,
+                nullptr,
+                nullptr,
+                MPI_DATATYPE_NULL,
+                root,
+                comm,
+                &r);
+        }
+        return r;
+    }
+
+    template <std::ranges::contiguous_range Range>
+    [[nodiscard]]
+    auto gather(
+        Range& values,
+        std::span<int const> counts,
+        std::span<int const> offsets,
+        rank_t root = 0,
+        communicator const& comm = world(),
+        sloc_t sloc = sloc_t::current()) -> request_t
+        requires mpi_typed<std::ranges::range_value_t<Range>>
+    {
+        return gather(std::ranges::data(values), counts, offsets, root, comm, sloc);
+    }
+
+    /// Scatters in place, each rank receives the `count` elements at
+    /// `values + rank * count` from `root`.
+    template <mpi_typed T>
+    [[nodiscard]]
+    auto scatter(
+        T* values,
+        count_t count,
+        rank_t root = 0,
+        communicator const& comm = world(),
+        sloc_t sloc = sloc_t::current()) -> request_t
+    {
+        auto const [m, t] = large(type<T>, count, sloc);
+        request_t r;
+        if (comm.rank() == root) {
+            check(
+                sloc,
+                tiny_mpi_large_op(MPI_Iscatter),
+                values,
+                m,
+                t,
+                MPI_IN_PLACE,
+                0,
+                MPI_DATATYPE_NULL,
+                root,
+                comm,
+                &r);
+        }
+        else {
+            check(
+                sloc,
+                tiny_mpi_large_op(MPI_Iscatter),
+                nullptr,
+                0,
+                MPI_DATATYPE_NULL,
+                values + comm.rank() * count,
+                m,
+                t,
+                root,
+                comm,
+                &r);
+        }
+        return r;
+    }
+
+    template <std::ranges::contiguous_range Range>
+    [[nodiscard]]
+    auto scatter(
+        Range& values,
+        rank_t root = 0,
+        communicator const& comm = world(),
+        sloc_t sloc = sloc_t::current()) -> request_t
+        requires mpi_typed<std::ranges::range_value_t<Range>>
+    {
+        return scatter(std::ranges::data(values), 1, root, comm, sloc);
+    }
+
+    /// Scatters in place, each rank receives the `counts[rank]` elements at
+    /// `values + offsets[rank]` from `root`.
+    template <mpi_typed T>
+    [[nodiscard]]
+    auto scatter(
+        T* values,
+        std::span<int const> counts,
+        std::span<int const> offsets,
+        rank_t root = 0,
+        communicator const& comm = world(),
+        sloc_t sloc = sloc_t::current()) -> request_t
+    {
+        request_t r;
+        if (comm.rank() == root) {
+            check(
+                sloc,
+                tiny_mpi_check_op(MPI_Iscatterv),
+                values,
+                data(counts),
+                data(offsets),
+                type<T>,
+                MPI_IN_PLACE,
+                0,
+                MPI_DATATYPE_NULL,
+                root,
+                comm,
+                &r);
+        }
+        else {
+            check(
+                sloc,
+                tiny_mpi_check_op(MPI_Iscatterv),
+                nullptr,
+                nullptr,
+                nullptr,
+                MPI_DATATYPE_NULL,
+                values + offsets[comm.rank()],
+                counts[comm.rank()],
+                type<T>,
+                root,
+                comm,
+                &r);
+        }
+        return r;
+    }
+
+    template <std::ranges::contiguous_range Range>
+    [[nodiscard]]
+    auto scatter(
+        Range& values,
+        std::span<int const> counts,
+        std::span<int const> offsets,
+        rank_t root = 0,
+        communicator const& comm = world(),
+        sloc_t sloc = sloc_t::current()) -> request_t
+        requires mpi_typed<std::ranges::range_value_t<Range>>
+    {
+        return scatter(std::ranges::data(values), counts, offsets, root, comm, sloc);
+    }
+
+    template <mpi_typed T>
+    [[nodiscard]]
+    auto alltoall(
+        const T* from,
+        T* to,
+        count_t count,
+        communicator const& comm = world(),
+        sloc_t sloc = sloc_t::current()) -> request_t
+    {
+        auto const [m, t] = large(type<T>, count, sloc);
+        request_t r;
+        check(sloc, tiny_mpi_large_op(MPI_Ialltoall), from, m, t, to, m, t, comm, &r);
+        return r;
+    }
+
+    /// Sends the `i`th block of `size(from) / n_ranks` elements to rank `i`.
+    template <std::ranges::contiguous_range From, std::ranges::contiguous_range To>
+    [[nodiscard]]
+    auto alltoall(
+        From const& from,
+        To& to,
+        communicator const& comm = world(),
+        sloc_t sloc = sloc_t::current()) -> request_t
+        requires mpi_typed<std::ranges::range_value_t<From>>
+            and std::same_as<std::ranges::range_value_t<From>, std::ranges::range_value_t<To>>
+    {
+        return alltoall(
+            std::ranges::data(from),
+            std::ranges::data(to),
+            std::ranges::size(from) / comm.n_ranks(),
+            comm,
+            sloc);
+    }
+
+    template <mpi_typed T>
+    [[nodiscard]]
+    auto alltoallv(
+        const T* from,
+        std::span<int const> from_counts,
+        std::span<int const> from_offsets,
+        T* to,
+        std::span<int const> to_counts,
+        std::span<int const> to_offsets,
+        communicator const& comm = world(),
+        sloc_t sloc = sloc_t::current()) -> request_t
+    {
+        request_t r;
+        check(
+            sloc,
+            tiny_mpi_check_op(MPI_Ialltoallv),
+            from,
+            data(from_counts),
+            data(from_offsets),
+            type<T>,
+            to,
+            data(to_counts),
+            data(to_offsets),
+            type<T>,
+            comm,
+            &r);
+        return r;
+    }
+
+    /// The result of an alltoallv() exchange, partitioned by source rank.
+    ///
+    /// Owns the packed send buffer (if any) and the receive buffer, and waits
+    /// for the exchange on destruction.
+    template <mpi_typed T>
+    class partitioned
+    {
+        std::vector<T> _from;
+        std::vector<T> _values;
+        std::vector<int> _counts;
+        std::vector<int> _offsets;
+        request_t _request = MPI_REQUEST_NULL;
+
+      public:
+        partitioned() = default;
+
+        /// Starts the exchange of a bucketed buffer, see alltoallv().
+        partitioned(
+            std::span<T const> values,
+            std::span<int const> counts,
+            communicator const& comm,
+            sloc_t sloc)
+        {
+            _start(values, counts, comm, sloc);
+        }
+
+        /// Starts the exchange of a packed buffer, which is kept alive until the
+        /// exchange completes.
+        partitioned(
+            std::vector<T> from,
+            std::span<int const> counts,
+            communicator const& comm,
+            sloc_t sloc)
+                : _from(std::move(from))
+        {
+            _start(_from, counts, comm, sloc);
+        }
+
+        partitioned(partitioned&& b) noexcept
+                : _from(std::move(b._from))
+                , _values(std::move(b._values))
+                , _counts(std::move(b._counts))
+                , _offsets(std::move(b._offsets))
+                , _request(std::exchange(b._request, MPI_REQUEST_NULL))
+        {
+        }
+
+        auto operator=(partitioned&& b) noexcept -> partitioned& {
+            if (this != &b) {
+                wait();
+                _from = std::move(b._from);
+                _values = std::move(b._values);
+                _counts = std::move(b._counts);
+                _offsets = std::move(b._offsets);
+                _request = std::exchange(b._request, MPI_REQUEST_NULL);
+            }
+            return *this;
+        }
+
+        ~partitioned() {
+            wait();
+        }
+
+        /// The exchange request, for use with request_pool and friends.
+        [[nodiscard]]
+        auto request() noexcept -> request_t& {
+            return _request;
+        }
+
+        /// Blocks until the exchange is complete.
+        void wait(sloc_t sloc = sloc_t::current()) noexcept {
+            tiny_mpi::wait(std::span(&_request, 1), sloc);
+        }
+
+        /// The number of source ranks.
+        [[nodiscard]]
+        auto size() const noexcept -> std::size_t {
+            return _counts.size();
+        }
+
+        /// The elements received from `source`, valid once the exchange is
+        /// complete.
+        [[nodiscard]]
+        auto operator[](rank_t source) const noexcept -> std::span<T const> {
+            return { _values.data() + _offsets[source], std::size_t(_counts[source]) };
+        }
+
+        /// All received elements, ordered by source rank.
+        [[nodiscard]]
+        auto values() noexcept -> std::span<T> {
+            return _values;
+        }
+
+        [[nodiscard]]
+        auto counts() const noexcept -> std::span<int const> {
+            return _counts;
+        }
+
+        [[nodiscard]]
+        auto offsets() const noexcept -> std::span<int const> {
+            return _offsets;
+        }
+
+      private:
+        void _start(
+            std::span<T const> values,
+            std::span<int const> from_counts,
+            communicator const& comm,
+            sloc_t sloc)
+        {
+            if (ssize(from_counts) != comm.n_ranks()) {
+                print_error("MPI_Alltoall", MPI_ERR_COUNT, sloc);
+                abort(MPI_ERR_COUNT, sloc);
+            }
+
+            std::vector<int> from_offsets(from_counts.size());
+            std::exclusive_scan(from_counts.begin(), from_counts.end(), from_offsets.begin(), 0);
+
+            _counts.resize(comm.n_ranks());
+            _offsets.resize(comm.n_ranks());
+            check(sloc, tiny_mpi_check_op(MPI_Alltoall), data(from_counts), 1, MPI_INT, data(_counts), 1, MPI_INT, comm);
+            std::exclusive_scan(_counts.begin(), _counts.end(), _offsets.begin(), 0);
+            _values.resize(_offsets.back() + _counts.back());
+
+            _request = alltoallv(
+                data(values),
+                from_counts,
+                from_offsets,
+                data(_values),
+                _counts,
+                _offsets,
+                comm,
+                sloc);
+        }
+    };
+
+    /// Exchanges a bucketed buffer, where `values` holds `counts[i]` elements
+    /// for rank `i` ordered by destination.
+    ///
+    /// The receive counts are exchanged with a blocking MPI_Alltoall, then the
+    /// payload is posted with MPI_Ialltoallv into a buffer allocated once.
+    /// `values` must stay valid until the exchange completes.
+    template <std::ranges::contiguous_range Range>
+    [[nodiscard]]
+    auto alltoallv(
+        Range const& values,
+        std::span<int const> counts,
+        communicator const& comm = world(),
+        sloc_t sloc = sloc_t::current())
+        requires mpi_typed<std::ranges::range_value_t<Range>>
+    {
+        using T = std::ranges::range_value_t<Range>;
+        return partitioned<T>(std::span<T const>(values), counts, comm, sloc);
+    }
+
+    /// Exchanges a per-destination range of ranges, where `buckets[i]` is sent
+    /// to rank `i`. The buckets are packed into a buffer owned by the result.
+    template <std::ranges::input_range Buckets>
+    [[nodiscard]]
+    auto alltoallv(
+        Buckets const& buckets,
+        communicator const& comm = world(),
+        sloc_t sloc = sloc_t::current())
+        requires std::ranges::sized_range<std::ranges::range_value_t<Buckets>>
+            and mpi_typed<std::ranges::range_value_t<std::ranges::range_value_t<Buckets>>>
+    {
+        using T = std::ranges::range_value_t<std::ranges::range_value_t<Buckets>>;
+
+        std::vector<int> counts;
+        std::vector<T> from;
+        for (auto const& bucket : buckets) {
+            counts.push_back(std::ranges::size(bucket));
+            from.insert(from.end(), std::ranges::begin(bucket), std::ranges::end(bucket));
+        }
+
+        return partitioned<T>(std::move(from), counts, comm, sloc);
+    }
+
+    /// Sends `count` elements of `from` to every out-neighbor and receives
+    /// `count` elements from each in-neighbor into consecutive blocks of `to`.
+    template <mpi_typed T>
+    [[nodiscard]]
+    auto neighbor_allgather(
+        const T* from,
+        count_t count,
+        T* to,
+        communicator const& comm,
+        sloc_t sloc = sloc_t::current()) -> request_t
+    {
+        auto const [m, t] = large(type<T>, count, sloc);
+        request_t r;
+        check(sloc, tiny_mpi_large_op(MPI_Ineighbor_allgather), from, m, t, to, m, t, comm, &r);
+        return r;
+    }
+
+    template <std::ranges::contiguous_range From, std::ranges::contiguous_range To>
+    [[nodiscard]]
+    auto neighbor_allgather(
+        From const& from,
+        To& to,
+        communicator const& comm,
+        sloc_t sloc = sloc_t::current()) -> request_t
+        requires mpi_typed<std::ranges::range_value_t<From>>
+            and std::same_as<std::ranges::range_value_t<From>, std::ranges::range_value_t<To>>
+    {
+        return neighbor_allgather(
+            std::ranges::data(from),
+            std::ranges::size(from),
+            std::ranges::data(to),
+            comm,
+            sloc);
+    }
+
+    /// Sends the `i`th block of `count` elements to the `i`th out-neighbor and
+    /// receives a block from each in-neighbor.
+    template <mpi_typed T>
+    [[nodiscard]]
+    auto neighbor_alltoall(
+        const T* from,
+        T* to,
+        count_t count,
+        communicator const& comm,
+        sloc_t sloc = sloc_t::current()) -> request_t
+    {
+        auto const [m, t] = large(type<T>, count, sloc);
+        request_t r;
+        check(sloc, tiny_mpi_large_op(MPI_Ineighbor_alltoall), from, m, t, to, m, t, comm, &r);
+        return r;
+    }
+
+    /// The block size is `size(from)` divided by the out-degree.
+    template <std::ranges::contiguous_range From, std::ranges::contiguous_range To>
+    [[nodiscard]]
+    auto neighbor_alltoall(
+        From const& from,
+        To& to,
+        communicator const& comm,
+        sloc_t sloc = sloc_t::current()) -> request_t
+        requires mpi_typed<std::ranges::range_value_t<From>>
+            and std::same_as<std::ranges::range_value_t<From>, std::ranges::range_value_t<To>>
+    {
+        auto [in, out] = comm.degrees(sloc);
+        return neighbor_alltoall(
+            std::ranges::data(from),
+            std::ranges::data(to),
+            out ? count_t(std::ranges::size(from) / out) : 0,
+            comm,
+            sloc);
+    }
+
+    template <mpi_typed T>
+    [[nodiscard]]
+    auto neighbor_alltoallv(
+        const T* from,
+        std::span<int const> from_counts,
+        std::span<int const> from_offsets,
+        T* to,
+        std::span<int const> to_counts,
+        std::span<int const> to_offsets,
+        communicator const& comm,
+        sloc_t sloc = sloc_t::current()) -> request_t
+    {
+        request_t r;
+        check(
+            sloc,
+            tiny_mpi_check_op(MPI_Ineighbor_alltoallv),
+            from,
+            data(from_counts),
+            data(from_offsets),
+            type<T>,
+            to,
+            data(to_counts),
+            data(to_offsets),
+            type<T>,
+            comm,
+            &r);
+        return r;
+    }
+
+    template <std::ranges::contiguous_range From, std::ranges::contiguous_range To>
+    [[nodiscard]]
+    auto neighbor_alltoallv(
+        From const& from,
+        std::span<int const> from_counts,
+        std::span<int const> from_offsets,
+        To& to,
+        std::span<int const> to_counts,
+        std::span<int const> to_offsets,
+        communicator const& comm,
+        sloc_t sloc = sloc_t::current()) -> request_t
+        requires mpi_typed<std::ranges::range_value_t<From>>
+            and std::same_as<std::ranges::range_value_t<From>, std::ranges::range_value_t<To>>
+    {
+        return neighbor_alltoallv(
+            std::ranges::data(from),
+            from_counts,
+            from_offsets,
+            std::ranges::data(to),
+            to_counts,
+            to_offsets,
+            comm,
+            sloc);
+    }
+
+    /// Inclusive prefix reduction in place, rank `i` ends up with the reduction
+    /// over ranks `0..i`.
+    template <mpi_typed T>
+    [[nodiscard]]
+    auto scan(
+        T* buffer,
+        count_t n,
+        MPI_Op op = sum_op<T>(),
+        communicator const& comm = world(),
+        sloc_t sloc = sloc_t::current()) -> request_t
+    {
+        return _chunked(n, [&](count_t i, int m) {
+            request_t r;
+            check(sloc, tiny_mpi_check_op(MPI_Iscan), MPI_IN_PLACE, buffer + i, m, type<T>, op, comm, &r);
+            return r;
+        }, sloc);
+    }
+
+    template <mpi_typed T, reduction_for<T> Op>
+    [[nodiscard]]
+    auto scan(
+        T* v,
+        count_t n,
+        Op,
+        communicator const& comm = world(),
+        sloc_t sloc = sloc_t::current()) -> request_t
+    {
+        return scan(v, n, mpi_op<Op, T>(), comm, sloc);
+    }
+
+    template <std::ranges::contiguous_range Range>
+    [[nodiscard]]
+    auto scan(
+        Range& v,
+        MPI_Op op = sum_op<std::ranges::range_value_t<Range>>(),
+        communicator const& comm = world(),
+        sloc_t sloc = sloc_t::current()) -> request_t
+        requires mpi_typed<std::ranges::range_value_t<Range>>
+    {
+        return scan(
+            std::ranges::data(v),
+            std::ranges::size(v),
+            op,
+            comm,
+            sloc);
+    }
+
+    template <std::ranges::contiguous_range Range, class Op>
+    [[nodiscard]]
+    auto scan(
+        Range& v,
+        Op,
+        communicator const& comm = world(),
+        sloc_t sloc = sloc_t::current()) -> request_t
+        requires mpi_typed<std::ranges::range_value_t<Range>>
+            and reduction_for<Op, std::ranges::range_value_t<Range>>
+    {
+        return scan(v, mpi_op<Op, std::ranges::range_value_t<Range>>(), comm, sloc);
+    }
+
+    template <mpi_typed T>
+    [[nodiscard]]
+    auto scan(
+        T& value,
+        MPI_Op op = sum_op<T>(),
+        communicator const& comm = world(),
+        sloc_t sloc = sloc_t::current()) -> request_t
+    {
+        return scan(std::addressof(value), 1, op, comm, sloc);
+    }
+
+    template <mpi_typed T, reduction_for<T> Op>
+    [[nodiscard]]
+    auto scan(
+        T& value,
+        Op,
+        communicator const& comm = world(),
+        sloc_t sloc = sloc_t::current()) -> request_t
+    {
+        return scan(value, mpi_op<Op, T>(), comm, sloc);
+    }
+
+    /// Exclusive prefix reduction in place, rank `i` ends up with the reduction
+    /// over ranks `0..i-1`. The buffer on rank 0 is undefined afterwards.
+    template <mpi_typed T>
+    [[nodiscard]]
+    auto exscan(
+        T* buffer,
+        count_t n,
+        MPI_Op op = sum_op<T>(),
+        communicator const& comm = world(),
+        sloc_t sloc = sloc_t::current()) -> request_t
+    {
+        return _chunked(n, [&](count_t i, int m) {
+            request_t r;
+            check(sloc, tiny_mpi_check_op(MPI_Iexscan), MPI_IN_PLACE, buffer + i, m, type<T>, op, comm, &r);
+            return r;
+        }, sloc);
+    }
+
+    template <mpi_typed T, reduction_for<T> Op>
+    [[nodiscard]]
+    auto exscan(
+        T* v,
+        count_t n,
+        Op,
+        communicator const& comm = world(),
+        sloc_t sloc = sloc_t::current()) -> request_t
+    {
+        return exscan(v, n, mpi_op<Op, T>(), comm, sloc);
+    }
+
+    template <std::ranges::contiguous_range Range>
+    [[nodiscard]]
+    auto exscan(
+        Range& v,
+        MPI_Op op = sum_op<std::ranges::range_value_t<Range>>(),
+        communicator const& comm = world(),
+        sloc_t sloc = sloc_t::current()) -> request_t
+        requires mpi_typed<std::ranges::range_value_t<Range>>
+    {
+        return exscan(
+            std::ranges::data(v),
+            std::ranges::size(v),
+            op,
+            comm,
+            sloc);
+    }
+
+    template <std::ranges::contiguous_range Range, class Op>
+    [[nodiscard]]
+    auto exscan(
+        Range& v,
+        Op,
+        communicator const& comm = world(),
+        sloc_t sloc = sloc_t::current()) -> request_t
+        requires mpi_typed<std::ranges::range_value_t<Range>>
+            and reduction_for<Op, std::ranges::range_value_t<Range>>
+    {
+        return exscan(v, mpi_op<Op, std::ranges::range_value_t<Range>>(), comm, sloc);
+    }
+
+    template <mpi_typed T>
+    [[nodiscard]]
+    auto exscan(
+        T& value,
+        MPI_Op op = sum_op<T>(),
+        communicator const& comm = world(),
+        sloc_t sloc = sloc_t::current()) -> request_t
+    {
+        return exscan(std::addressof(value), 1, op, comm, sloc);
+    }
+
+    template <mpi_typed T, reduction_for<T> Op>
+    [[nodiscard]]
+    auto exscan(
+        T& value,
+        Op,
+        communicator const& comm = world(),
+        sloc_t sloc = sloc_t::current()) -> request_t
+    {
+        return exscan(value, mpi_op<Op, T>(), comm, sloc);
+    }
+
+    /// Reduces the `n_ranks * count` elements of `buffer` in place, rank `i` ends
+    /// up with block `i` of the result in its first `count` elements.
+    template <mpi_typed T>
+    [[nodiscard]]
+    auto reduce_scatter_block(
+        T* buffer,
+        count_t count,
+        MPI_Op op = sum_op<T>(),
+        communicator const& comm = world(),
+        sloc_t sloc = sloc_t::current()) -> request_t
+    {
+        request_t r;
+#if MPI_VERSION >= 4
+        check(sloc, tiny_mpi_check_op(MPI_Ireduce_scatter_block_c), MPI_IN_PLACE, buffer, count, type<T>, op, comm, &r);
+#else
+        if (count > std::numeric_limits<int>::max()) [[unlikely]] {
+            // Reduce each block to its owner in chunks and move ours to the
+            // front, which completes before returning.
+            for (rank_t i : comm.ranks()) {
+                wait(reduce(buffer + i * count, count, op, i, comm, sloc));
+            }
+            std::copy_n(buffer + comm.rank() * count, count, buffer);
+            return MPI_REQUEST_NULL;
+        }
+        check(sloc, tiny_mpi_check_op(MPI_Ireduce_scatter_block), MPI_IN_PLACE, buffer, int(count), type<T>, op, comm, &r);
+#endif
+        return r;
+    }
+
+    template <mpi_typed T, reduction_for<T> Op>
+    [[nodiscard]]
+    auto reduce_scatter_block(
+        T* buffer,
+        count_t count,
+        Op,
+        communicator const& comm = world(),
+        sloc_t sloc = sloc_t::current()) -> request_t
+    {
+        return reduce_scatter_block(buffer, count, mpi_op<Op, T>(), comm, sloc);
+    }
+
+    /// The block size is `size(v) / n_ranks`.
+    template <std::ranges::contiguous_range Range>
+    [[nodiscard]]
+    auto reduce_scatter_block(
+        Range& v,
+        MPI_Op op = sum_op<std::ranges::range_value_t<Range>>(),
+        communicator const& comm = world(),
+        sloc_t sloc = sloc_t::current()) -> request_t
+        requires mpi_typed<std::ranges::range_value_t<Range>>
+    {
+        return reduce_scatter_block(
+            std::ranges::data(v),
+            std::ranges::size(v) / comm.n_ranks(),
+            op,
+            comm,
+            sloc);
+    }
+
+    template <std::ranges::contiguous_range Range, class Op>
+    [[nodiscard]]
+    auto reduce_scatter_block(
+        Range& v,
+        Op,
+        communicator const& comm = world(),
+        sloc_t sloc = sloc_t::current()) -> request_t
+        requires mpi_typed<std::ranges::range_value_t<Range>>
+            and reduction_for<Op, std::ranges::range_value_t<Range>>
+    {
+        return reduce_scatter_block(v, mpi_op<Op, std::ranges::range_value_t<Range>>(), comm, sloc);
+    }
+
+    /// Reduces the `sum(counts)` elements of `buffer` in place, rank `i` ends up
+    /// with its `counts[i]` block of the result in its first elements.
+    template <mpi_typed T>
+    [[nodiscard]]
+    auto reduce_scatter(
+        T* buffer,
+        std::span<int const> counts,
+        MPI_Op op = sum_op<T>(),
+        communicator const& comm = world(),
+        sloc_t sloc = sloc_t::current()) -> request_t
+    {
+        request_t r;
+        check(sloc, tiny_mpi_check_op(MPI_Ireduce_scatter), MPI_IN_PLACE, buffer, data(counts), type<T>, op, comm, &r);
+        return r;
+    }
+
+    template <mpi_typed T, reduction_for<T> Op>
+    [[nodiscard]]
+    auto reduce_scatter(
+        T* buffer,
+        std::span<int const> counts,
+        Op,
+        communicator const& comm = world(),
+        sloc_t sloc = sloc_t::current()) -> request_t
+    {
+        return reduce_scatter(buffer, counts, mpi_op<Op, T>(), comm, sloc);
+    }
+
+    template <std::ranges::contiguous_range Range>
+    [[nodiscard]]
+    auto reduce_scatter(
+        Range& v,
+        std::span<int const> counts,
+        MPI_Op op = sum_op<std::ranges::range_value_t<Range>>(),
+        communicator const& comm = world(),
+        sloc_t sloc = sloc_t::current()) -> request_t
+        requires mpi_typed<std::ranges::range_value_t<Range>>
+    {
+        return reduce_scatter(std::ranges::data(v), counts, op, comm, sloc);
+    }
+
+    template <std::ranges::contiguous_range Range, class Op>
+    [[nodiscard]]
+    auto reduce_scatter(
+        Range& v,
+        std::span<int const> counts,
+        Op,
+        communicator const& comm = world(),
+        sloc_t sloc = sloc_t::current()) -> request_t
+        requires mpi_typed<std::ranges::range_value_t<Range>>
+            and reduction_for<Op, std::ranges::range_value_t<Range>>
+    {
+        return reduce_scatter(v, counts, mpi_op<Op, std::ranges::range_value_t<Range>>(), comm, sloc);
+    }
+
+    /// A group of persistent requests.
+    ///
+    /// The send(), recv(), allreduce(), and allgather() members mirror the
+    /// nonblocking wrappers but only set up the operation; start() posts the
+    /// whole group and wait() completes it, after which the group can be started
+    /// again.
+    ///
+    /// Collectives use MPI_Allreduce_init and friends with MPI 4. Older
+    /// libraries fall back to reposting the nonblocking collective on start().
+    class persistent
+    {
+        using _repost_t = std::function<auto() -> request_t>;
+
+        std::vector<request_t> _requests;
+        std::vector<std::pair<std::size_t, _repost_t>> _reposts;
+
+      public:
+        persistent() = default;
+
+        persistent(persistent&& b) noexcept
+                : _requests(std::exchange(b._requests, {}))
+                , _reposts(std::exchange(b._reposts, {}))
+        {
+        }
+
+        auto operator=(persistent&& b) noexcept -> persistent& {
+            if (this != &b) {
+                _free();
+                _requests = std::exchange(b._requests, {});
+                _reposts = std::exchange(b._reposts, {});
+            }
+            return *this;
+        }
+
+        ~persistent() {
+            _free();
+        }
+
+        template <mpi_typed T>
+        void send(
+            const T* from,
+            count_t n,
+            rank_t to_rank,
+            tag_t tag = 0,
+            communicator const& comm = world(),
+            sloc_t sloc = sloc_t::current())
+        {
+            auto const [m, t] = large(type<T>, n, sloc);
+            request_t& r = _requests.emplace_back();
+            check(sloc, tiny_mpi_large_op(MPI_Send_init), from, m, t, to_rank, tag, comm, &r);
+        }
+
+        template <trivially_copyable T>
+        void send(
+            const T* from,
+            count_t n,
+            rank_t to_rank,
+            tag_t tag = 0,
+            communicator const& comm = world(),
+            sloc_t sloc = sloc_t::current())
+        {
+            auto const [m, t] = large(type<char>, count_t(sizeof(T)) * n, sloc);
+            request_t& r = _requests.emplace_back();
+            check(sloc, tiny_mpi_large_op(MPI_Send_init), from, m, t, to_rank, tag, comm, &r);
+        }
+
+        void send(
+            std::ranges::contiguous_range auto const& from,
+            rank_t to_rank,
+            tag_t tag = 0,
+            communicator const& comm = world(),
+            sloc_t sloc = sloc_t::current())
+        {
+            send(
+                std::ranges::data(from),
+                std::ranges::size(from),
+                to_rank,
+                tag,
+                comm,
+                std::move(sloc));
+        }
+
+        template <mpi_typed T>
+        void recv(
+            T* to,
+            count_t n,
+            rank_t from_rank,
+            tag_t tag = 0,
+            communicator const& comm = world(),
+            sloc_t sloc = sloc_t::current())
+        {
+            auto const [m, t] = large(type<T>, n, sloc);
+            request_t& r = _requests.emplace_back();
+            check(sloc, tiny_mpi_large_op(MPI_Recv_init), to, m, t, from_rank, tag, comm, &r);
+        }
+
+        template <trivially_copyable T>
+        void recv(
+            T* to,
+            count_t n,
+            rank_t from_rank,
+            tag_t tag = 0,
+            communicator const& comm = world(),
+            sloc_t sloc = sloc_t::current())
+        {
+            auto const [m, t] = large(type<char>, count_t(sizeof(T)) * n, sloc);
+            request_t& r = _requests.emplace_back();
+            check(sloc, tiny_mpi_large_op(MPI_Recv_init), to, m, t, from_rank, tag, comm, &r);
+        }
+
+        void recv(
+            std::ranges::contiguous_range auto& to,
+            rank_t from_rank,
+            tag_t tag = 0,
+            communicator const& comm = world(),
+            sloc_t sloc = sloc_t::current())
+        {
+            recv(
+                std::ranges::data(to),
+                std::ranges::size(to),
+                from_rank,
+                tag,
+                comm,
+                std::move(sloc));
+        }
+
+        template <mpi_typed T>
+        void allreduce(
+            T* buffer,
+            count_t n,
+            MPI_Op op = sum_op<T>(),
+            communicator const& comm = world(),
+            sloc_t sloc = sloc_t::current())
+        {
+            _for_chunks(n, [&](count_t i, int m) {
+#if MPI_VERSION >= 4
+                request_t& r = _requests.emplace_back();
+                check(sloc, tiny_mpi_check_op(MPI_Allreduce_init), MPI_IN_PLACE, buffer + i, m, type<T>, op, comm, MPI_INFO_NULL, &r);
+#else
+                _repost([=, comm = MPI_Comm(comm)] {
+                    request_t r;
+                    check(sloc, tiny_mpi_check_op(MPI_Iallreduce), MPI_IN_PLACE, buffer + i, m, type<T>, op, comm, &r);
+                    return r;
+                });
+#endif
+            });
+        }
+
+        template <mpi_typed T, reduction_for<T> Op>
+        void allreduce(
+            T* v,
+            count_t n,
+            Op,
+            communicator const& comm = world(),
+            sloc_t sloc = sloc_t::current())
+        {
+            allreduce(v, n, mpi_op<Op, T>(), comm, sloc);
+        }
+
+        template <std::ranges::contiguous_range Range>
+        void allreduce(
+            Range& v,
+            MPI_Op op = sum_op<std::ranges::range_value_t<Range>>(),
+            communicator const& comm = world(),
+            sloc_t sloc = sloc_t::current())
+            requires mpi_typed<std::ranges::range_value_t<Range>>
+        {
+            allreduce(
+                std::ranges::data(v),
+                std::ranges::size(v),
+                op,
+                comm,
+                sloc);
+        }
+
+        template <std::ranges::contiguous_range Range, class Op>
+        void allreduce(
+            Range& v,
+            Op,
+            communicator const& comm = world(),
+            sloc_t sloc = sloc_t::current())
+            requires mpi_typed<std::ranges::range_value_t<Range>>
+                and reduction_for<Op, std::ranges::range_value_t<Range>>
+        {
+            allreduce(v, mpi_op<Op, std::ranges::range_value_t<Range>>(), comm, sloc);
+        }
+
+        template <mpi_typed T>
+        void allreduce(
+            T& value,
+            MPI_Op op = sum_op<T>(),
+            communicator const& comm = world(),
+            sloc_t sloc = sloc_t::current())
+        {
+            allreduce(std::addressof(value), 1, op, comm, sloc);
+        }
+
+        template <mpi_typed T>
+        void allgather(
+            T* values,
+            count_t count,
+            communicator const& comm = world(),
+            sloc_t sloc = sloc_t::current())
+        {
+            auto const [m, t] = large(type<T>, count, sloc);
+#if MPI_VERSION >= 4
+            request_t& r = _requests.emplace_back();
+            check(
+                sloc,
+                tiny_mpi_large_op(MPI_Allgather_init),
+                MPI_IN_PLACE,
+                0,
+                MPI_DATATYPE_NULL,
+                values,
+                m,
+                t,
+                comm,
+                MPI_INFO_NULL,
+                &r);
+#else
+            _repost([=, comm = MPI_Comm(comm)] {
+                request_t r;
+                check(
+                    sloc,
+                    tiny_mpi_large_op(MPI_Iallgather),
+                    MPI_IN_PLACE,
+                    0,
+                    MPI_DATATYPE_NULL,
+                    values,
+                    m,
+                    t,
+                    comm,
+                    &r);
+                return r;
+            });
+#endif
+        }
+
+        template <std::ranges::contiguous_range Range>
+        void allgather(
+            Range& values,
+            communicator const& comm = world(),
+            sloc_t sloc = sloc_t::current())
+            requires mpi_typed<std::ranges::range_value_t<Range>>
+        {
+            allgather(std::ranges::data(values), 1, comm, sloc);
+        }
+
+        /// The `counts` and `offsets` must outlive the group.
+        template <mpi_typed T>
+        void allgather(
+            T* values,
+            std::span<int const> counts,
+            std::span<int const> offsets,
+            communicator const& comm = world(),
+            sloc_t sloc = sloc_t::current())
+        {
+#if MPI_VERSION >= 4
+            request_t& r = _requests.emplace_back();
+            check(
+                sloc,
+                tiny_mpi_check_op(MPI_Allgatherv_init),
+                MPI_IN_PLACE,
+                0,
+                MPI_DATATYPE_NULL,
+                values,
+                data(counts),
+                data(offsets),
+                type<T>,
+                comm,
+                MPI_INFO_NULL,
+                &r);
+#else
+            _repost([=, comm = MPI_Comm(comm)] {
+                request_t r;
+                check(
+                    sloc,
+                    tiny_mpi_check_op(MPI_Iallgatherv),
+                    MPI_IN_PLACE,
+                    0,
+                    MPI_DATATYPE_NULL,
+                    values,
+                    data(counts),
+                    data(offsets),
+                    type<T>,
+                    comm,
+                    &r);
+                return r;
+            });
+#endif
+        }
+
+        template <std::ranges::contiguous_range Range>
+        void allgather(
+            Range& values,
+            std::span<int const> counts,
+            std::span<int const> offsets,
+            communicator const& comm = world(),
+            sloc_t sloc = sloc_t::current())
+            requires mpi_typed<std::ranges::range_value_t<Range>>
+        {
+            allgather(std::ranges::data(values), counts, offsets, comm, sloc);
+        }
+
+        /// Starts every request in the group.
+        void start(
+            sloc_t = sloc_t::current()) noexcept;   //!< debugging location
+
+        /// Blocks until every request in the group is complete.
+        void wait(
+            sloc_t = sloc_t::current()) noexcept;   //!< debugging location
+
+        [[nodiscard]]
+        auto requests() noexcept -> std::span<request_t> {
+            return _requests;
+        }
+
+      private:
+        void _repost(_repost_t f) {
+            _reposts.emplace_back(_requests.size(), std::move(f));
+            _requests.push_back(MPI_REQUEST_NULL);
+        }
+
+        void _free() noexcept;
+    };
+
+    /// A growable set of outstanding requests with completion-driven progress.
+    ///
+    /// Requests are identified by the slot index returned from add(). Completed
+    /// slots are recycled by later calls to add(). The pool owns its requests
+    /// and waits for any still outstanding when it is destroyed.
+    class request_pool
+    {
+        std::vector<request_t> _requests;
+        std::vector<int> _completed;
+        std::vector<int> _free;
+
+      public:
+        request_pool() = default;
+        request_pool(request_pool&&) = default;
+
+        /// Completes outstanding requests, so their buffers are not written
+        /// after they are freed.
+        ~request_pool();
+
+        /// Takes ownership of `r` and returns its slot.
+        auto add(request_t r) -> int;
+
+        /// The number of outstanding requests.
+        [[nodiscard]]
+        auto size() const noexcept -> std::size_t {
+            return _requests.size() - _free.size();
+        }
+
+        [[nodiscard]]
+        auto empty() const noexcept -> bool {
+            return size() == 0;
+        }
+
+        /// Blocks until one request completes, returns -1 if the pool is empty.
+        auto wait_any(
+            sloc_t = sloc_t::current()) noexcept    //!< debugging location
+            -> int;
+
+        /// Blocks until at least one request completes and returns the completed
+        /// slots, the span is valid until the next call.
+        auto wait_some(
+            sloc_t = sloc_t::current()) noexcept    //!< debugging location
+            -> std::span<int const>;
+
+        /// Returns the completed slots without blocking, the span is valid until
+        /// the next call.
+        auto test_some(
+            sloc_t = sloc_t::current()) noexcept    //!< debugging location
+            -> std::span<int const>;
+
+        /// Blocks until every request is complete.
+        void wait_all(
+            sloc_t = sloc_t::current()) noexcept;   //!< debugging location
+
+        /// Calls `f(slot)` as each request completes until the pool is empty,
+        /// `f` may add() new requests but must not wait on the pool.
+        void drain(
+            std::invocable<int> auto&& f,
+            sloc_t sloc = sloc_t::current())
+        {
+            while (not empty()) {
+                for (int i : wait_some(sloc)) {
+                    f(i);
+                }
+            }
+        }
+
+      private:
+        auto _retire(int outcount) -> std::span<int const>;
+    };
+
+    /// Posts `post(data + offset, m)` for each chunk of at most `chunk` of `n`
+    /// elements and calls `f(span)` for each completed chunk, in order.
+    template <class T>
+    void _pipelined(
+        T* data,
+        count_t n,
+        count_t chunk,
+        auto&& post,
+        auto&& f,
+        sloc_t sloc)
+    {
+        if (chunk <= 0) {
+            print_error("_pipelined", MPI_ERR_COUNT, sloc);
+            abort(MPI_ERR_COUNT, sloc);
+        }
+
+        count_t const n_chunks = std::max<count_t>(1, (n + chunk - 1) / chunk);
+        auto piece = [&](count_t i) {
+            return std::span<T>(data + i * chunk, std::min(chunk, n - i * chunk));
+        };
+
+        request_pool pool;
+        std::vector<count_t> index;
+        for (count_t i = 0; i < n_chunks; ++i) {
+            auto p = piece(i);
+            std::size_t slot = pool.add(post(p.data(), count_t(p.size())));
+            if (index.size() <= slot) {
+                index.resize(slot + 1);
+            }
+            index[slot] = i;
+        }
+
+        std::vector<bool> done(n_chunks);
+        count_t next = 0;
+        pool.drain([&](int slot) {
+            done[index[slot]] = true;
+            for (; next < n_chunks and done[next]; ++next) {
+                f(piece(next));
+            }
+        }, sloc);
+    }
+
+    /// Sends `from` as consecutive messages of `chunk` elements that are all
+    /// outstanding at once, blocking until every chunk is sent.
+    ///
+    /// The matching chunked_recv() must use the same `chunk`. `f(span)` is
+    /// called in order as each chunk's send completes, e.g., to release it.
+    template <std::ranges::contiguous_range Range>
+    void chunked_send(
+        Range const& from,
+        rank_t to_rank,
+        count_t chunk,
+        std::invocable<std::span<std::ranges::range_value_t<Range> const>> auto&& f,
+        tag_t tag = 0,
+        communicator const& comm = world(),
+        sloc_t sloc = sloc_t::current())
+        requires mpi_typed<std::ranges::range_value_t<Range>>
+    {
+        _pipelined(std::ranges::data(from), std::ranges::size(from), chunk, [&](auto* p, count_t m) {
+            return send(p, m, to_rank, tag, comm, sloc);
+        }, f, sloc);
+    }
+
+    template <std::ranges::contiguous_range Range>
+    void chunked_send(
+        Range const& from,
+        rank_t to_rank,
+        count_t chunk,
+        tag_t tag = 0,
+        communicator const& comm = world(),
+        sloc_t sloc = sloc_t::current())
+        requires mpi_typed<std::ranges::range_value_t<Range>>
+    {
+        chunked_send(from, to_rank, chunk, [](auto) {}, tag, comm, sloc);
+    }
+
+    /// Receives `to` as consecutive messages of `chunk` elements, blocking until
+    /// the last one arrives.
+    ///
+    /// `f(span)` is called in order as each chunk arrives, so consuming it, e.g.,
+    /// deserializing or writing it out, overlaps with the rest of the transfer.
+    ///
+    ///     tiny_mpi::chunked_recv(buffer, 0, 1 << 20, [&](std::span<char> c) {
+    ///         out.write(c.data(), c.size());
+    ///     });
+    template <std::ranges::contiguous_range Range>
+    void chunked_recv(
+        Range& to,
+        rank_t from_rank,
+        count_t chunk,
+        std::invocable<std::span<std::ranges::range_value_t<Range>>> auto&& f,
+        tag_t tag = 0,
+        communicator const& comm = world(),
+        sloc_t sloc = sloc_t::current())
+        requires mpi_typed<std::ranges::range_value_t<Range>>
+    {
+        _pipelined(std::ranges::data(to), std::ranges::size(to), chunk, [&](auto* p, count_t m) {
+            return recv(p, m, from_rank, tag, comm, sloc);
+        }, f, sloc);
     }
 
     template <std::size_t N>
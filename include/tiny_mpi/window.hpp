@@ -0,0 +1,382 @@
+#ifndef TINY_MPI_CXX_INCLUDE_TINY_MPI_WINDOW_HPP
+#define TINY_MPI_CXX_INCLUDE_TINY_MPI_WINDOW_HPP
+
+#include "tiny_mpi/tiny_mpi.hpp"
+
+#include <span>
+#include <utility>
+
+namespace tiny_mpi
+{
+    /// An RMA window of `size()` local elements of `T` on each rank.
+    ///
+    /// Offsets are in elements of the target's window. One-sided operations
+    /// need an access epoch, e.g., a passive-target lock_all(), and complete at
+    /// the next flush() or unlock.
+    ///
+    ///     tiny_mpi::window<std::int64_t> table(buckets);
+    ///     table.lock_all();
+    ///     auto old = table.fetch_and_op(1, owner(key), slot(key));
+    ///     table.unlock_all();
+    ///
+    /// Construction and destruction are collective over the communicator.
+    template <mpi_typed T>
+    class window
+    {
+        MPI_Win _win = MPI_WIN_NULL;
+        T* _data = nullptr;
+        count_t _size = 0;
+
+      public:
+        window() = default;
+
+        /// MPI_Win_allocate, collective over `comm`.
+        explicit window(
+            count_t n,                                  //!< local elements
+            communicator const& comm = world(),         //!< communicator
+            sloc_t sloc = sloc_t::current()) noexcept   //!< debugging location
+                : _size(n)
+        {
+            check(
+                sloc,
+                tiny_mpi_check_op(MPI_Win_allocate),
+                MPI_Aint(n * sizeof(T)),
+                int(sizeof(T)),
+                MPI_INFO_NULL,
+                comm,
+                &_data,
+                &_win);
+        }
+
+        /// MPI_Win_allocate_shared, every rank of `comm` must share a node, e.g.,
+        /// world().split_type(). Peer segments are directly addressable through
+        /// local().
+        [[nodiscard]]
+        static auto shared(
+            count_t n,                                  //!< local elements
+            communicator const& comm,                   //!< node-local communicator
+            sloc_t sloc = sloc_t::current()) noexcept   //!< debugging location
+            -> window
+        {
+            window w;
+            w._size = n;
+            check(
+                sloc,
+                tiny_mpi_check_op(MPI_Win_allocate_shared),
+                MPI_Aint(n * sizeof(T)),
+                int(sizeof(T)),
+                MPI_INFO_NULL,
+                comm,
+                &w._data,
+                &w._win);
+            return w;
+        }
+
+        window(window&& b) noexcept
+                : _win(std::exchange(b._win, MPI_WIN_NULL))
+                , _data(std::exchange(b._data, nullptr))
+                , _size(std::exchange(b._size, 0))
+        {
+        }
+
+        auto operator=(window&& b) noexcept -> window& {
+            if (this != &b) {
+                _free();
+                _win = std::exchange(b._win, MPI_WIN_NULL);
+                _data = std::exchange(b._data, nullptr);
+                _size = std::exchange(b._size, 0);
+            }
+            return *this;
+        }
+
+        ~window() {
+            _free();
+        }
+
+        operator MPI_Win() const noexcept {
+            return _win;
+        }
+
+        explicit operator bool() const noexcept {
+            return _win != MPI_WIN_NULL;
+        }
+
+        [[nodiscard]]
+        auto data() const noexcept -> T* {
+            return _data;
+        }
+
+        [[nodiscard]]
+        auto size() const noexcept -> count_t {
+            return _size;
+        }
+
+        /// This rank's segment.
+        [[nodiscard]]
+        auto local() const noexcept -> std::span<T> {
+            return { _data, std::size_t(_size) };
+        }
+
+        /// The segment of `rank` in a shared() window, for direct load/store.
+        [[nodiscard]]
+        auto local(
+            rank_t rank,                                //!< rank in the window's group
+            sloc_t sloc = sloc_t::current()) const noexcept
+            -> std::span<T>
+        {
+            MPI_Aint bytes;
+            int disp_unit;
+            T* base;
+            check(sloc, tiny_mpi_check_op(MPI_Win_shared_query), _win, rank, &bytes, &disp_unit, &base);
+            return { base, std::size_t(bytes) / sizeof(T) };
+        }
+
+        /// Starts a passive-target epoch to every rank.
+        void lock_all(sloc_t sloc = sloc_t::current()) const noexcept {
+            check(sloc, tiny_mpi_check_op(MPI_Win_lock_all), 0, _win);
+        }
+
+        void unlock_all(sloc_t sloc = sloc_t::current()) const noexcept {
+            check(sloc, tiny_mpi_check_op(MPI_Win_unlock_all), _win);
+        }
+
+        /// Starts a passive-target epoch to `rank`.
+        void lock(
+            rank_t rank,                                //!< target
+            bool exclusive = false,                     //!< MPI_LOCK_EXCLUSIVE
+            sloc_t sloc = sloc_t::current()) const noexcept
+        {
+            check(sloc, tiny_mpi_check_op(MPI_Win_lock), exclusive ? MPI_LOCK_EXCLUSIVE : MPI_LOCK_SHARED, rank, 0, _win);
+        }
+
+        void unlock(rank_t rank, sloc_t sloc = sloc_t::current()) const noexcept {
+            check(sloc, tiny_mpi_check_op(MPI_Win_unlock), rank, _win);
+        }
+
+        /// Completes outstanding operations to `rank` at the origin and target.
+        void flush(rank_t rank, sloc_t sloc = sloc_t::current()) const noexcept {
+            check(sloc, tiny_mpi_check_op(MPI_Win_flush), rank, _win);
+        }
+
+        void flush_all(sloc_t sloc = sloc_t::current()) const noexcept {
+            check(sloc, tiny_mpi_check_op(MPI_Win_flush_all), _win);
+        }
+
+        /// Completes outstanding operations to `rank` at the origin only.
+        void flush_local(rank_t rank, sloc_t sloc = sloc_t::current()) const noexcept {
+            check(sloc, tiny_mpi_check_op(MPI_Win_flush_local), rank, _win);
+        }
+
+        /// Synchronizes the public and private copies of the local segment,
+        /// needed between direct load/store and RMA on shared() windows.
+        void sync(sloc_t sloc = sloc_t::current()) const noexcept {
+            check(sloc, tiny_mpi_check_op(MPI_Win_sync), _win);
+        }
+
+        /// Active-target synchronization, collective over the window.
+        void fence(sloc_t sloc = sloc_t::current()) const noexcept {
+            check(sloc, tiny_mpi_check_op(MPI_Win_fence), 0, _win);
+        }
+
+        void put(
+            T const* from,
+            count_t n,
+            rank_t target,
+            MPI_Aint offset,
+            sloc_t sloc = sloc_t::current()) const
+        {
+            auto const [m, t] = large(type<T>, n, sloc);
+            check(sloc, tiny_mpi_large_op(MPI_Put), from, m, t, target, offset, m, t, _win);
+        }
+
+        void put(
+            T const& value,
+            rank_t target,
+            MPI_Aint offset,
+            sloc_t sloc = sloc_t::current()) const
+        {
+            put(std::addressof(value), 1, target, offset, sloc);
+        }
+
+        void get(
+            T* to,
+            count_t n,
+            rank_t target,
+            MPI_Aint offset,
+            sloc_t sloc = sloc_t::current()) const
+        {
+            auto const [m, t] = large(type<T>, n, sloc);
+            check(sloc, tiny_mpi_large_op(MPI_Get), to, m, t, target, offset, m, t, _win);
+        }
+
+        /// Applies `op` elementwise at the target, atomically per element.
+        void accumulate(
+            T const* from,
+            count_t n,
+            rank_t target,
+            MPI_Aint offset,
+            MPI_Op op = MPI_SUM,
+            sloc_t sloc = sloc_t::current()) const
+        {
+            auto const [m, t] = large(type<T>, n, sloc);
+            check(sloc, tiny_mpi_large_op(MPI_Accumulate), from, m, t, target, offset, m, t, op, _win);
+        }
+
+        /// RMA only supports builtin ops.
+        template <reduction_op Op>
+        void accumulate(
+            T const* from,
+            count_t n,
+            rank_t target,
+            MPI_Aint offset,
+            Op,
+            sloc_t sloc = sloc_t::current()) const
+        {
+            accumulate(from, n, target, offset, op<Op>, sloc);
+        }
+
+        /// Atomically applies `op` to one element at the target and returns its
+        /// previous value, flushing locally. Requires an access epoch.
+        [[nodiscard]]
+        auto fetch_and_op(
+            T const& value,
+            rank_t target,
+            MPI_Aint offset,
+            MPI_Op op = MPI_SUM,
+            sloc_t sloc = sloc_t::current()) const -> T
+        {
+            T out;
+            check(sloc, tiny_mpi_check_op(MPI_Fetch_and_op), std::addressof(value), &out, type<T>, target, offset, op, _win);
+            flush_local(target, sloc);
+            return out;
+        }
+
+        template <reduction_op Op>
+        [[nodiscard]]
+        auto fetch_and_op(
+            T const& value,
+            rank_t target,
+            MPI_Aint offset,
+            Op,
+            sloc_t sloc = sloc_t::current()) const -> T
+        {
+            return fetch_and_op(value, target, offset, op<Op>, sloc);
+        }
+
+        /// Atomically replaces one element at the target with `desired` if it
+        /// equals `expected` and returns its previous value, flushing locally.
+        /// Requires an access epoch.
+        [[nodiscard]]
+        auto compare_and_swap(
+            T const& desired,
+            T const& expected,
+            rank_t target,
+            MPI_Aint offset,
+            sloc_t sloc = sloc_t::current()) const -> T
+        {
+            T out;
+            check(
+                sloc,
+                tiny_mpi_check_op(MPI_Compare_and_swap),
+                std::addressof(desired),
+                std::addressof(expected),
+                &out,
+                type<T>,
+                target,
+                offset,
+                _win);
+            flush_local(target, sloc);
+            return out;
+        }
+
+        /// Request-based put, the request completes locally. Requires a
+        /// passive-target epoch.
+        [[nodiscard]]
+        auto rput(
+            T const* from,
+            count_t n,
+            rank_t target,
+            MPI_Aint offset,
+            sloc_t sloc = sloc_t::current()) const -> request_t
+        {
+            auto const [m, t] = large(type<T>, n, sloc);
+            request_t r;
+            check(sloc, tiny_mpi_large_op(MPI_Rput), from, m, t, target, offset, m, t, _win, &r);
+            return r;
+        }
+
+        /// Request-based get, `to` is valid once the request completes. Requires
+        /// a passive-target epoch.
+        [[nodiscard]]
+        auto rget(
+            T* to,
+            count_t n,
+            rank_t target,
+            MPI_Aint offset,
+            sloc_t sloc = sloc_t::current()) const -> request_t
+        {
+            auto const [m, t] = large(type<T>, n, sloc);
+            request_t r;
+            check(sloc, tiny_mpi_large_op(MPI_Rget), to, m, t, target, offset, m, t, _win, &r);
+            return r;
+        }
+
+        template <std::ranges::contiguous_range Range>
+        void put(
+            Range const& from,
+            rank_t target,
+            MPI_Aint offset,
+            sloc_t sloc = sloc_t::current()) const
+            requires std::same_as<std::ranges::range_value_t<Range>, T>
+        {
+            put(std::ranges::data(from), std::ranges::size(from), target, offset, sloc);
+        }
+
+        template <std::ranges::contiguous_range Range>
+        void get(
+            Range& to,
+            rank_t target,
+            MPI_Aint offset,
+            sloc_t sloc = sloc_t::current()) const
+            requires std::same_as<std::ranges::range_value_t<Range>, T>
+        {
+            get(std::ranges::data(to), std::ranges::size(to), target, offset, sloc);
+        }
+
+        template <std::ranges::contiguous_range Range>
+        [[nodiscard]]
+        auto rput(
+            Range const& from,
+            rank_t target,
+            MPI_Aint offset,
+            sloc_t sloc = sloc_t::current()) const -> request_t
+            requires std::same_as<std::ranges::range_value_t<Range>, T>
+        {
+            return rput(std::ranges::data(from), std::ranges::size(from), target, offset, sloc);
+        }
+
+        template <std::ranges::contiguous_range Range>
+        [[nodiscard]]
+        auto rget(
+            Range& to,
+            rank_t target,
+            MPI_Aint offset,
+            sloc_t sloc = sloc_t::current()) const -> request_t
+            requires std::same_as<std::ranges::range_value_t<Range>, T>
+        {
+            return rget(std::ranges::data(to), std::ranges::size(to), target, offset, sloc);
+        }
+
+      private:
+        void _free() noexcept {
+            if (_win != MPI_WIN_NULL and not finalized()) {
+                check(sloc_t::current(), tiny_mpi_check_op(MPI_Win_free), &_win);
+            }
+            _win = MPI_WIN_NULL;
+            _data = nullptr;
+            _size = 0;
+        }
+    };
+}
+
+#endif // TINY_MPI_CXX_INCLUDE_TINY_MPI_WINDOW_HPP
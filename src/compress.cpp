@@ -0,0 +1,255 @@
+#include "tiny_mpi/compress.hpp"
+#include <cstdio>
+#include <cstring>
+
+// The encoded stream is a sequence of tokens. A control byte `c < 128` is
+// followed by `c + 1` literal bytes, a control byte `c >= 128` is followed by
+// one byte that repeats `c - 125` times.
+namespace
+{
+    constexpr std::size_t _max_literal = 128;
+    constexpr std::size_t _min_run = 3;
+    constexpr std::size_t _max_run = 130;
+
+    void _shuffle(std::span<std::byte const> in, std::size_t width, std::byte* out)
+    {
+        std::size_t n = in.size() / width;
+        for (std::size_t k = 0; k < width; ++k) {
+            for (std::size_t i = 0; i < n; ++i) {
+                *out++ = in[i * width + k];
+            }
+        }
+        std::memcpy(out, in.data() + n * width, in.size() - n * width);
+    }
+
+    void _unshuffle(std::byte const* in, std::size_t width, std::span<std::byte> out)
+    {
+        std::size_t n = out.size() / width;
+        for (std::size_t k = 0; k < width; ++k) {
+            for (std::size_t i = 0; i < n; ++i) {
+                out[i * width + k] = *in++;
+            }
+        }
+        std::memcpy(out.data() + n * width, in, out.size() - n * width);
+    }
+
+    void _corrupt(std::size_t have, std::size_t want, tiny_mpi::sloc_t sloc)
+    {
+        fprintf(stderr, "%s:%u compressed payload decodes to %zu bytes, expected %zu\n",
+                sloc.function_name(), unsigned(sloc.line()), have, want);
+        tiny_mpi::abort(MPI_ERR_TRUNCATE, sloc);
+    }
+}
+
+void
+tiny_mpi::compress(std::span<std::byte const> in, std::size_t width, std::vector<std::byte>& out)
+    noexcept
+{
+    std::vector<std::byte> shuffled(in.size());
+    _shuffle(in, width, shuffled.data());
+
+    std::size_t const n = shuffled.size();
+    std::size_t literal = 0;                    // start of the pending literal
+    std::size_t i = 0;
+
+    auto flush = [&](std::size_t end) {
+        while (literal < end) {
+            std::size_t m = std::min(_max_literal, end - literal);
+            out.push_back(std::byte(m - 1));
+            out.insert(out.end(), &shuffled[literal], &shuffled[literal] + m);
+            literal += m;
+        }
+    };
+
+    while (i < n) {
+        std::size_t run = 1;
+        while (i + run < n and run < _max_run and shuffled[i + run] == shuffled[i]) {
+            ++run;
+        }
+
+        if (run < _min_run) {
+            i += run;
+            continue;
+        }
+
+        flush(i);
+        out.push_back(std::byte(run + 125));
+        out.push_back(shuffled[i]);
+        i += run;
+        literal = i;
+    }
+    flush(n);
+}
+
+void
+tiny_mpi::decompress(std::span<std::byte const> in, std::size_t width, std::span<std::byte> out, sloc_t sloc)
+    noexcept
+{
+    std::vector<std::byte> shuffled(out.size());
+
+    std::size_t j = 0;
+    for (std::size_t i = 0; i < in.size();) {
+        std::size_t c = std::size_t(in[i++]);
+        if (c < _max_literal) {
+            std::size_t m = c + 1;
+            if (in.size() - i < m or shuffled.size() - j < m) {
+                _corrupt(j + m, out.size(), sloc);
+            }
+            std::memcpy(&shuffled[j], &in[i], m);
+            i += m;
+            j += m;
+        }
+        else {
+            std::size_t m = c - 125;
+            if (i == in.size() or shuffled.size() - j < m) {
+                _corrupt(j + m, out.size(), sloc);
+            }
+            std::memset(&shuffled[j], int(in[i++]), m);
+            j += m;
+        }
+    }
+
+    if (j != out.size()) {
+        _corrupt(j, out.size(), sloc);
+    }
+
+    _unshuffle(shuffled.data(), width, out);
+}
+
+void
+tiny_mpi::compressed_send(
+    std::span<std::byte const> from,
+    std::size_t width,
+    rank_t to_rank,
+    tag_t tag,
+    compression c,
+    communicator const& comm,
+    sloc_t sloc)
+    noexcept
+{
+    std::vector<std::byte> encoded;
+    if (c.threshold <= from.size()) {
+        compress(from, width, encoded);
+    }
+
+    if (encoded.empty() or from.size() <= encoded.size()) {
+        auto const [m, t] = large(MPI_BYTE, ssize(from), sloc);
+        check(sloc, tiny_mpi_large_op(MPI_Send), from.data(), m, t, to_rank, tag, comm);
+    }
+    else {
+        auto const [m, t] = large(MPI_BYTE, ssize(encoded), sloc);
+        check(sloc, tiny_mpi_large_op(MPI_Send), encoded.data(), m, t, to_rank, tag, comm);
+    }
+}
+
+void
+tiny_mpi::compressed_recv(
+    std::span<std::byte> to,
+    std::size_t width,
+    rank_t from_rank,
+    tag_t tag,
+    compression c,
+    communicator const& comm,
+    sloc_t sloc)
+    noexcept
+{
+    if (to.size() < c.threshold) {
+        auto const [k, t] = large(MPI_BYTE, ssize(to), sloc);
+        check(sloc, tiny_mpi_large_op(MPI_Recv), to.data(), k, t, from_rank, tag, comm, MPI_STATUS_IGNORE);
+        return;
+    }
+
+    MPI_Message m;
+    MPI_Status status;
+    check(sloc, tiny_mpi_check_op(MPI_Mprobe), from_rank, tag, comm, &m, &status);
+
+    count_t const n = get_count(status, MPI_BYTE, sloc);
+    auto const [k, t] = large(MPI_BYTE, n, sloc);
+
+    // An uncompressed payload is exactly the expected size, anything shorter
+    // is encoded.
+    if (std::size_t(n) == to.size()) {
+        check(sloc, tiny_mpi_large_op(MPI_Mrecv), to.data(), k, t, &m, MPI_STATUS_IGNORE);
+        return;
+    }
+
+    std::vector<std::byte> encoded(n);
+    check(sloc, tiny_mpi_large_op(MPI_Mrecv), encoded.data(), k, t, &m, MPI_STATUS_IGNORE);
+    decompress(encoded, width, to, sloc);
+}
+
+void
+tiny_mpi::compressed_allgather(
+    std::span<std::byte> values,
+    std::size_t width,
+    compression c,
+    communicator const& comm,
+    sloc_t sloc)
+    noexcept
+{
+    rank_t const rank = comm.rank();
+    rank_t const n_ranks = comm.n_ranks();
+
+    std::size_t const block = values.size() / n_ranks;
+    if (block < c.threshold) {
+        auto const [m, t] = large(MPI_BYTE, count_t(block), sloc);
+        check(sloc, tiny_mpi_large_op(MPI_Allgather), MPI_IN_PLACE, 0, MPI_DATATYPE_NULL, values.data(), m, t, comm);
+        return;
+    }
+
+    auto mine = values.subspan(rank * block, block);
+    std::vector<std::byte> encoded;
+    compress(mine, width, encoded);
+    if (block <= encoded.size()) {
+        encoded.assign(mine.begin(), mine.end());
+    }
+
+    std::vector<count_t> sizes(n_ranks);
+    sizes[rank] = ssize(encoded);
+    check(sloc, tiny_mpi_check_op(MPI_Allgather), MPI_IN_PLACE, 0, MPI_DATATYPE_NULL, data(sizes), 1, MPI_COUNT, comm);
+
+    std::vector<count_t> offsets(n_ranks);
+    std::exclusive_scan(sizes.begin(), sizes.end(), offsets.begin(), count_t(0));
+
+    std::vector<std::byte> gathered(offsets.back() + sizes.back());
+    if (gathered.size() <= std::size_t(std::numeric_limits<int>::max())) [[likely]] {
+        std::vector<int> counts(sizes.begin(), sizes.end());
+        std::vector<int> displacements(offsets.begin(), offsets.end());
+        check(
+            sloc,
+            tiny_mpi_check_op(MPI_Allgatherv),
+            encoded.data(),
+            int(encoded.size()),
+            MPI_BYTE,
+            gathered.data(),
+            data(counts),
+            data(displacements),
+            MPI_BYTE,
+            comm);
+    }
+    else {
+        // The displacements overflow an int, broadcast each block instead.
+        std::memcpy(gathered.data() + offsets[rank], encoded.data(), encoded.size());
+        std::vector<request_t> requests(n_ranks);
+        for (rank_t i = 0; i < n_ranks; ++i) {
+            auto const [m, t] = large(MPI_BYTE, sizes[i], sloc);
+            check(sloc, tiny_mpi_large_op(MPI_Ibcast), gathered.data() + offsets[i], m, t, i, comm, &requests[i]);
+        }
+        wait(requests, sloc);
+    }
+
+    for (int i = 0; i < n_ranks; ++i) {
+        if (i == rank) {
+            continue;
+        }
+
+        auto from = std::span(gathered).subspan(offsets[i], sizes[i]);
+        auto to = values.subspan(i * block, block);
+        if (from.size() == block) {
+            std::memcpy(to.data(), from.data(), block);
+        }
+        else {
+            decompress(from, width, to, sloc);
+        }
+    }
+}
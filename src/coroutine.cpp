@@ -0,0 +1,50 @@
+#include "tiny_mpi/coroutine.hpp"
+
+tiny_mpi::scheduler::~scheduler()
+{
+    // A suspended frame owns the buffers its request targets.
+    if (not _pool.empty() and not finalized()) {
+        _pool.wait_all();
+    }
+
+    for (auto h : _ready) {
+        h.destroy();
+    }
+
+    for (auto h : _waiting) {
+        if (h) {
+            h.destroy();
+        }
+    }
+}
+
+void
+tiny_mpi::scheduler::run(sloc_t sloc)
+    noexcept
+{
+    while (not _ready.empty() or not _pool.empty()) {
+        std::swap(_ready, _batch);
+        for (auto h : _batch) {
+            h.resume();
+            if (h.done()) {
+                h.destroy();
+            }
+        }
+        _batch.clear();
+
+        auto completed = _ready.empty() ? _pool.wait_some(sloc) : _pool.test_some(sloc);
+        for (int i : completed) {
+            _ready.push_back(std::exchange(_waiting[i], nullptr));
+        }
+    }
+}
+
+void
+tiny_mpi::scheduler::_suspend(request_t r, std::coroutine_handle<> h)
+{
+    std::size_t i = _pool.add(r);
+    if (_waiting.size() <= i) {
+        _waiting.resize(i + 1);
+    }
+    _waiting[i] = h;
+}
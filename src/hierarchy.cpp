@@ -0,0 +1,166 @@
+#include "tiny_mpi/hierarchy.hpp"
+#include <array>
+#include <cstring>
+
+tiny_mpi::node_hierarchy::node_hierarchy(communicator const& comm, sloc_t sloc)
+    noexcept
+        : _comm(comm.dup(sloc))
+        , _node(_comm.split_type(MPI_COMM_TYPE_SHARED, 0, sloc))
+        , _leaders(_comm.split(_node.rank() == 0 ? 0 : MPI_UNDEFINED, 0, sloc))
+{
+    int index = _leaders ? _leaders.rank() : 0;
+    check(sloc, tiny_mpi_check_op(MPI_Bcast), &index, 1, MPI_INT, 0, _node);
+
+    // Every rank's {node, rank on node}, to lay out the gathered blocks node
+    // by node.
+    std::vector<std::array<int, 2>> where(_comm.n_ranks());
+    where[_comm.rank()] = { index, _node.rank() };
+    check(sloc, tiny_mpi_check_op(MPI_Allgather), MPI_IN_PLACE, 0, MPI_DATATYPE_NULL, where.data(), 2, MPI_INT, _comm);
+
+    for (auto [node, _] : where) {
+        if (_node_sizes.size() <= std::size_t(node)) {
+            _node_sizes.resize(node + 1);
+        }
+        ++_node_sizes[node];
+    }
+    _node_offsets.resize(_node_sizes.size());
+    std::exclusive_scan(_node_sizes.begin(), _node_sizes.end(), _node_offsets.begin(), 0);
+
+    _order.resize(where.size());
+    for (rank_t i : _comm.ranks()) {
+        _order[_node_offsets[where[i][0]] + where[i][1]] = i;
+    }
+    _position = _node_offsets[index] + _node.rank();
+}
+
+tiny_mpi::node_hierarchy::~node_hierarchy()
+{
+    if (_segment and not finalized()) {
+        _segment.unlock_all();
+    }
+}
+
+void
+tiny_mpi::node_hierarchy::_reserve(std::size_t bytes, sloc_t sloc)
+    noexcept
+{
+    if (bytes <= _capacity) {
+        return;
+    }
+
+    if (_segment) {
+        _segment.unlock_all(sloc);
+    }
+
+    _capacity = std::max((bytes + 63) / 64 * 64, 2 * _capacity);
+    _segment = window<char>::shared(_capacity, _node, sloc);
+    _segment.lock_all(sloc);
+}
+
+void
+tiny_mpi::node_hierarchy::_fence(sloc_t sloc) const
+    noexcept
+{
+    _segment.sync(sloc);
+    check(sloc, tiny_mpi_check_op(MPI_Barrier), _node);
+    _segment.sync(sloc);
+}
+
+void
+tiny_mpi::node_hierarchy::_allreduce(
+    void* buffer,
+    count_t n,
+    std::size_t size,
+    MPI_Datatype type,
+    MPI_Op op,
+    sloc_t sloc)
+    noexcept
+{
+    int commutative;
+    check(sloc, tiny_mpi_check_op(MPI_Op_commutative), op, &commutative);
+    if (not commutative) {
+        wait(_chunked(n, [&](count_t i, int m) {
+            request_t r;
+            check(sloc, tiny_mpi_check_op(MPI_Iallreduce), MPI_IN_PLACE, (char*)buffer + i * size, m, type, op, _comm, &r);
+            return r;
+        }, sloc));
+        return;
+    }
+
+    std::size_t const bytes = n * size;
+    rank_t const k = _node.n_ranks();
+    rank_t const me = _node.rank();
+
+    _reserve(bytes, sloc);
+    auto segment = [&](rank_t i) { return _segment.local(i, sloc).data(); };
+
+    std::memcpy(segment(me), buffer, bytes);
+    _fence(sloc);
+
+    // Each node rank reduces its slice of every segment into the last one.
+    count_t const lo = n * me / k;
+    count_t const hi = n * (me + 1) / k;
+    char* const out = segment(k - 1);
+    for (rank_t i = k - 1; i-- != 0;) {
+        char const* in = segment(i);
+        _for_chunks(hi - lo, [&](count_t j, int m) {
+            check(sloc, tiny_mpi_check_op(MPI_Reduce_local), in + (lo + j) * size, out + (lo + j) * size, m, type, op);
+        });
+    }
+    _fence(sloc);
+
+    if (_leaders) {
+        _for_chunks(n, [&](count_t i, int m) {
+            check(sloc, tiny_mpi_check_op(MPI_Allreduce), MPI_IN_PLACE, out + i * size, m, type, op, _leaders);
+        });
+    }
+    _fence(sloc);
+
+    std::memcpy(buffer, out, bytes);
+    check(sloc, tiny_mpi_check_op(MPI_Barrier), _node);
+}
+
+void
+tiny_mpi::node_hierarchy::_allgather(
+    void* values,
+    count_t count,
+    std::size_t size,
+    MPI_Datatype type,
+    sloc_t sloc)
+    noexcept
+{
+    std::size_t const block = count * size;
+    std::size_t const k = _node.n_ranks();
+
+    // MPI_Win_allocate_shared lays the node segments out contiguously unless
+    // asked for alloc_shared_noncontig, which window::shared() never does, so
+    // the gathered blocks can span them from local(0).
+    _reserve((_order.size() * block + k - 1) / k, sloc);
+    char* const all = _segment.local(0, sloc).data();
+
+    std::memcpy(all + _position * block, (char*)values + _comm.rank() * block, block);
+    _fence(sloc);
+
+    if (_leaders) {
+        // One element per rank, so the counts and displacements are in ranks
+        // and fit in an int however large `count` is.
+        MPI_Datatype const per_rank = large_type(type, count, sloc);
+        check(
+            sloc,
+            tiny_mpi_check_op(MPI_Allgatherv),
+            MPI_IN_PLACE,
+            0,
+            MPI_DATATYPE_NULL,
+            all,
+            data(_node_sizes),
+            data(_node_offsets),
+            per_rank,
+            _leaders);
+    }
+    _fence(sloc);
+
+    for (std::size_t i = 0; i < _order.size(); ++i) {
+        std::memcpy((char*)values + _order[i] * block, all + i * block, block);
+    }
+    check(sloc, tiny_mpi_check_op(MPI_Barrier), _node);
+}
@@ -0,0 +1,127 @@
+#include "tiny_mpi/kernels.hpp"
+#include <cstring>
+
+namespace {
+    enum _op_t {
+        SUM,
+        PROD,
+        MIN,
+        MAX
+    };
+
+    /// Applies `Op` to `W`-byte vectors, then finishes the tail with scalars. The
+    /// vector type lowers to the instruction set of the calling function, so the
+    /// combine step is written inline rather than as a separate function.
+    template <std::size_t W, _op_t Op, class T>
+    [[gnu::always_inline]]
+    inline void _apply(T const* in, T* inout, std::size_t n)
+    {
+        std::size_t i = 0;
+        if constexpr (W != 0) {
+            using V [[gnu::vector_size(W)]] = T;
+            constexpr std::size_t L = W / sizeof(T);
+            for (; i + L <= n; i += L) {
+                V a, b;
+                std::memcpy(&a, in + i, W);
+                std::memcpy(&b, inout + i, W);
+                if constexpr (Op == SUM)  b = a + b;
+                if constexpr (Op == PROD) b = a * b;
+                if constexpr (Op == MIN)  b = a < b ? a : b;
+                if constexpr (Op == MAX)  b = a < b ? b : a;
+                std::memcpy(inout + i, &b, W);
+            }
+        }
+
+        for (; i < n; ++i) {
+            T a = in[i], b = inout[i];
+            if constexpr (Op == SUM)  b = a + b;
+            if constexpr (Op == PROD) b = a * b;
+            if constexpr (Op == MIN)  b = a < b ? a : b;
+            if constexpr (Op == MAX)  b = a < b ? b : a;
+            inout[i] = b;
+        }
+    }
+
+    template <class T, _op_t Op>
+    void _scalar(T const* in, T* inout, std::size_t n)
+    {
+        _apply<0, Op>(in, inout, n);
+    }
+
+#if defined(__x86_64__) and defined(__GNUC__)
+    template <class T, _op_t Op>
+    [[gnu::target("avx2")]]
+    void _avx2(T const* in, T* inout, std::size_t n)
+    {
+        _apply<32, Op>(in, inout, n);
+    }
+
+    template <class T, _op_t Op>
+    [[gnu::target("avx512f,avx512dq")]]
+    void _avx512(T const* in, T* inout, std::size_t n)
+    {
+        _apply<64, Op>(in, inout, n);
+    }
+
+    auto _select() -> tiny_mpi::kernels::isa_t
+    {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f") and __builtin_cpu_supports("avx512dq")) {
+            return tiny_mpi::kernels::AVX512;
+        }
+        if (__builtin_cpu_supports("avx2")) {
+            return tiny_mpi::kernels::AVX2;
+        }
+        return tiny_mpi::kernels::SCALAR;
+    }
+#else
+    auto _select() -> tiny_mpi::kernels::isa_t
+    {
+        return tiny_mpi::kernels::SCALAR;
+    }
+#endif
+
+    /// Resolves the kernel for `T` and `Op` once, on first use.
+    template <class T, _op_t Op>
+    void _dispatch(T const* in, T* inout, std::size_t n)
+    {
+        using kernel_t = void (*)(T const*, T*, std::size_t);
+        static kernel_t const kernel = []() -> kernel_t {
+            switch (tiny_mpi::kernels::isa()) {
+#if defined(__x86_64__) and defined(__GNUC__)
+              case tiny_mpi::kernels::AVX512: return &_avx512<T, Op>;
+              case tiny_mpi::kernels::AVX2:   return &_avx2<T, Op>;
+#endif
+              default:                        return &_scalar<T, Op>;
+            }
+        }();
+        kernel(in, inout, n);
+    }
+}
+
+auto
+tiny_mpi::kernels::isa()
+    noexcept -> isa_t
+{
+    static isa_t const selected = _select();
+    return selected;
+}
+
+#define TINY_MPI_KERNEL(name, Op, T)                                    \
+    void                                                                \
+    tiny_mpi::kernels::name(T const* in, T* inout, std::size_t n)       \
+        noexcept                                                        \
+    {                                                                   \
+        _dispatch<T, Op>(in, inout, n);                                 \
+    }
+
+#define TINY_MPI_KERNELS(name, Op)                  \
+    TINY_MPI_KERNEL(name, Op, float)                \
+    TINY_MPI_KERNEL(name, Op, double)               \
+    TINY_MPI_KERNEL(name, Op, std::int32_t)         \
+    TINY_MPI_KERNEL(name, Op, std::int64_t)
+
+TINY_MPI_KERNELS(sum, SUM)
+TINY_MPI_KERNELS(prod, PROD)
+TINY_MPI_KERNELS(min, MIN)
+TINY_MPI_KERNELS(max, MAX)
@@ -0,0 +1,65 @@
+#include "tiny_mpi/progress.hpp"
+#include <cstdio>
+
+tiny_mpi::progress_engine::progress_engine(sloc_t sloc)
+    noexcept
+{
+    int provided;
+    check(sloc, tiny_mpi_check_op(MPI_Query_thread), &provided);
+    if (provided < MPI_THREAD_MULTIPLE) {
+        fprintf(stderr, "%s:%u progress_engine requires THREAD_MULTIPLE, have (%d)\n",
+                sloc.function_name(), unsigned(sloc.line()), provided);
+        abort(MPI_ERR_OTHER, sloc);
+    }
+
+    _thread = std::thread([this, sloc] { _run(sloc); });
+}
+
+tiny_mpi::progress_engine::~progress_engine()
+{
+    {
+        std::scoped_lock _(_lock);
+        _stop = true;
+    }
+    _wake.notify_one();
+    _thread.join();
+}
+
+void
+tiny_mpi::progress_engine::_run(sloc_t sloc)
+    noexcept
+{
+    std::vector<std::pair<request_t, _callback_t>> incoming;
+    while (true) {
+        {
+            std::unique_lock lock(_lock);
+            if (_pool.empty()) {
+                // Nothing to test, sleep until submit() or the destructor.
+                _wake.wait(lock, [this] { return _stop or not _incoming.empty(); });
+                if (_incoming.empty()) {
+                    return;
+                }
+            }
+            std::swap(incoming, _incoming);
+        }
+
+        for (auto& [r, f] : incoming) {
+            std::size_t i = _pool.add(r);
+            if (_callbacks.size() <= i) {
+                _callbacks.resize(i + 1);
+            }
+            _callbacks[i] = std::move(f);
+        }
+        bool idle = incoming.empty();
+        incoming.clear();
+
+        for (int i : _pool.test_some(sloc)) {
+            std::exchange(_callbacks[i], nullptr)();
+            idle = false;
+        }
+
+        if (idle) {
+            std::this_thread::yield();
+        }
+    }
+}
@@ -0,0 +1,38 @@
+#include "tiny_mpi/sender.hpp"
+
+auto
+tiny_mpi::exec::run_loop::run_once(sloc_t sloc)
+    noexcept -> bool
+{
+    if (not _ready.empty()) {
+        std::swap(_ready, _batch);
+        for (_task* t : _batch) {
+            t->_complete(t);
+        }
+        _batch.clear();
+
+        for (int i : _pool.test_some(sloc)) {
+            _ready.push_back(std::exchange(_waiting[i], nullptr));
+        }
+        return true;
+    }
+
+    if (not _pool.empty()) {
+        for (int i : _pool.wait_some(sloc)) {
+            _ready.push_back(std::exchange(_waiting[i], nullptr));
+        }
+        return true;
+    }
+
+    return false;
+}
+
+void
+tiny_mpi::exec::run_loop::_post(request_t r, _task* t)
+{
+    std::size_t i = _pool.add(r);
+    if (_waiting.size() <= i) {
+        _waiting.resize(i + 1);
+    }
+    _waiting[i] = t;
+}
@@ -0,0 +1,42 @@
+#include "tiny_mpi/termination.hpp"
+
+tiny_mpi::termination_detector::termination_detector(communicator const& comm, sloc_t sloc)
+    noexcept
+        : _comm(comm, sloc)
+        , _waves(comm.dup(sloc))
+{
+}
+
+tiny_mpi::termination_detector::~termination_detector()
+{
+    if (_request != MPI_REQUEST_NULL and not finalized()) {
+        check(sloc_t::current(), tiny_mpi_check_op(MPI_Wait), &_request, MPI_STATUS_IGNORE);
+    }
+}
+
+auto
+tiny_mpi::termination_detector::test(sloc_t sloc)
+    noexcept -> bool
+{
+    if (_done) {
+        return true;
+    }
+
+    if (_request == MPI_REQUEST_NULL) {
+        _wave = _counts;
+        check(sloc, tiny_mpi_check_op(MPI_Iallreduce), MPI_IN_PLACE, _wave.data(), 2, MPI_COUNT, MPI_SUM, _waves, &_request);
+        return false;
+    }
+
+    int flag;
+    check(sloc, tiny_mpi_check_op(MPI_Test), &_request, &flag, MPI_STATUS_IGNORE);
+    if (not flag) {
+        return false;
+    }
+
+    // Unchanged, balanced totals over two waves mean nothing was sent or
+    // received in between, so no message can still be in flight.
+    _done = (_wave[0] == _wave[1] and _wave == _last);
+    _last = _wave;
+    return _done;
+}
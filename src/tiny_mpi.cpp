@@ -1,5 +1,22 @@
 #include "tiny_mpi/tiny_mpi.hpp"
 #include <cstdio>
+#include <map>
+#include <mutex>
+
+namespace {
+    std::mutex _types_lock;
+    std::vector<MPI_Datatype> _types;
+
+    std::mutex _ops_lock;
+    std::vector<MPI_Op> _ops;
+
+    using _strided_key_t = std::pair<MPI_Datatype, std::vector<MPI_Aint>>;
+    std::mutex _strided_lock;
+    std::map<_strided_key_t, MPI_Datatype> _strided;
+
+    std::mutex _large_lock;
+    std::map<std::pair<MPI_Datatype, MPI_Count>, MPI_Datatype> _large;
+}
 
 bool
 tiny_mpi::initialized(sloc_t sloc)
@@ -35,6 +52,7 @@ tiny_mpi::init(tiny_mpi::thread_support_t support,
     int out;
     if (initialized(sloc)) {
         check(sloc_t::current(), tiny_mpi_check_op(MPI_Query_thread), &out);
+        (void)world();
         return static_cast<thread_support_t>(out);
     }
 
@@ -43,6 +61,7 @@ tiny_mpi::init(tiny_mpi::thread_support_t support,
                 sloc.function_name(), sloc.line(), e);
         exit(EXIT_FAILURE);
     }
+    (void)world();
     return static_cast<thread_support_t>(out);
 }
 
@@ -54,6 +73,32 @@ tiny_mpi::fini(sloc_t sloc)
         return;
     }
 
+    {
+        std::scoped_lock _(_types_lock);
+        for (MPI_Datatype& t : _types) {
+            check(sloc, tiny_mpi_check_op(MPI_Type_free), &t);
+        }
+        _types.clear();
+    }
+
+    {
+        std::scoped_lock _(_strided_lock);
+        _strided.clear();
+    }
+
+    {
+        std::scoped_lock _(_large_lock);
+        _large.clear();
+    }
+
+    {
+        std::scoped_lock _(_ops_lock);
+        for (MPI_Op& o : _ops) {
+            check(sloc, tiny_mpi_check_op(MPI_Op_free), &o);
+        }
+        _ops.clear();
+    }
+
     if (int e = MPI_Finalize()) {
         fprintf(stderr, "%s:%s MPI_Finalize failed with (%d)\n",
                 sloc.function_name(), sloc.line(), e);
@@ -90,16 +135,38 @@ tiny_mpi::print_error(const char* f, int e, sloc_t sloc)
             sloc.function_name(), sloc.line(), f, str, e);
 }
 
-int
-tiny_mpi::probe(rank_t source, MPI_Datatype type, tag_t tag, sloc_t sloc)
-    noexcept
+auto
+tiny_mpi::get_count(MPI_Status const& status, MPI_Datatype type, sloc_t sloc)
+    noexcept -> count_t
 {
-    MPI_Status status;
-    check(sloc, tiny_mpi_check_op(MPI_Probe), source, tag, MPI_COMM_WORLD, &status);
+#if MPI_VERSION >= 4
+    MPI_Count n;
+    check(sloc, tiny_mpi_check_op(MPI_Get_count_c), &status, type, &n);
+    return n;
+#else
+    // MPI_Get_count overflows above INT_MAX, for predefined types the element
+    // count is the same and does not.
+    int n_ints, n_addresses, n_types, combiner;
+    check(sloc, tiny_mpi_check_op(MPI_Type_get_envelope), type, &n_ints, &n_addresses, &n_types, &combiner);
+    if (combiner == MPI_COMBINER_NAMED) {
+        MPI_Count n;
+        check(sloc, tiny_mpi_check_op(MPI_Get_elements_x), &status, type, &n);
+        return n;
+    }
 
     int n;
     check(sloc, tiny_mpi_check_op(MPI_Get_count), &status, type, &n);
     return n;
+#endif
+}
+
+auto
+tiny_mpi::probe(rank_t source, MPI_Datatype type, tag_t tag, communicator const& comm, sloc_t sloc)
+    noexcept -> count_t
+{
+    MPI_Status status;
+    check(sloc, tiny_mpi_check_op(MPI_Probe), source, tag, comm, &status);
+    return get_count(status, type, sloc);
 }
 
 void
@@ -108,3 +175,432 @@ tiny_mpi::wait(std::span<request_t> reqs, sloc_t sloc)
 {
     check(sloc, tiny_mpi_check_op(MPI_Waitall), ssize(reqs), data(reqs), MPI_STATUSES_IGNORE);
 }
+
+tiny_mpi::communicator::communicator(MPI_Comm comm, sloc_t sloc)
+    noexcept
+        : _comm(comm)
+{
+    if (_comm != MPI_COMM_NULL) {
+        check(sloc, tiny_mpi_check_op(MPI_Comm_rank), _comm, &_rank);
+        check(sloc, tiny_mpi_check_op(MPI_Comm_size), _comm, &_n_ranks);
+    }
+}
+
+auto
+tiny_mpi::communicator::_adopt(MPI_Comm comm, sloc_t sloc)
+    noexcept -> communicator
+{
+    communicator c(comm, sloc);
+    c._owned = (comm != MPI_COMM_NULL);
+    return c;
+}
+
+void
+tiny_mpi::communicator::_free()
+    noexcept
+{
+    if (_owned and not finalized()) {
+        check(sloc_t::current(), tiny_mpi_check_op(MPI_Comm_free), &_comm);
+    }
+    _comm = MPI_COMM_NULL;
+    _owned = false;
+}
+
+auto
+tiny_mpi::communicator::split(int color, int key, sloc_t sloc) const
+    noexcept -> communicator
+{
+    MPI_Comm out;
+    check(sloc, tiny_mpi_check_op(MPI_Comm_split), _comm, color, key, &out);
+    return _adopt(out, sloc);
+}
+
+auto
+tiny_mpi::communicator::split_type(int type, int key, sloc_t sloc) const
+    noexcept -> communicator
+{
+    MPI_Comm out;
+    check(sloc, tiny_mpi_check_op(MPI_Comm_split_type), _comm, type, key, MPI_INFO_NULL, &out);
+    return _adopt(out, sloc);
+}
+
+auto
+tiny_mpi::communicator::dup(sloc_t sloc) const
+    noexcept -> communicator
+{
+    MPI_Comm out;
+    check(sloc, tiny_mpi_check_op(MPI_Comm_dup), _comm, &out);
+    return _adopt(out, sloc);
+}
+
+auto
+tiny_mpi::communicator::cart(std::span<int const> dims,
+                             std::span<int const> periods,
+                             bool reorder,
+                             sloc_t sloc) const
+    noexcept -> communicator
+{
+    if (dims.size() != periods.size()) {
+        print_error("MPI_Cart_create", MPI_ERR_DIMS, sloc);
+        abort(MPI_ERR_DIMS, sloc);
+    }
+
+    MPI_Comm out;
+    check(sloc, tiny_mpi_check_op(MPI_Cart_create), _comm, ssize(dims), data(dims), data(periods), reorder, &out);
+    return _adopt(out, sloc);
+}
+
+auto
+tiny_mpi::communicator::cart_sub(std::span<int const> remain, sloc_t sloc) const
+    noexcept -> communicator
+{
+    MPI_Comm out;
+    check(sloc, tiny_mpi_check_op(MPI_Cart_sub), _comm, data(remain), &out);
+    return _adopt(out, sloc);
+}
+
+auto
+tiny_mpi::communicator::cart_coords(rank_t rank, sloc_t sloc) const
+    noexcept -> std::vector<int>
+{
+    int n_dims;
+    check(sloc, tiny_mpi_check_op(MPI_Cartdim_get), _comm, &n_dims);
+
+    std::vector<int> coords(n_dims);
+    check(sloc, tiny_mpi_check_op(MPI_Cart_coords), _comm, rank, n_dims, data(coords));
+    return coords;
+}
+
+auto
+tiny_mpi::communicator::cart_shift(int dim, int displacement, sloc_t sloc) const
+    noexcept -> std::pair<rank_t, rank_t>
+{
+    std::pair<rank_t, rank_t> out;
+    check(sloc, tiny_mpi_check_op(MPI_Cart_shift), _comm, dim, displacement, &out.first, &out.second);
+    return out;
+}
+
+void
+tiny_mpi::persistent::start(sloc_t sloc)
+    noexcept
+{
+    if (_reposts.empty()) {
+        check(sloc, tiny_mpi_check_op(MPI_Startall), ssize(_requests), data(_requests));
+        return;
+    }
+
+    auto repost = _reposts.begin();
+    for (std::size_t i = 0; i < _requests.size(); ++i) {
+        if (repost != _reposts.end() and repost->first == i) {
+            _requests[i] = (repost++)->second();
+        }
+        else {
+            check(sloc, tiny_mpi_check_op(MPI_Start), &_requests[i]);
+        }
+    }
+}
+
+void
+tiny_mpi::persistent::wait(sloc_t sloc)
+    noexcept
+{
+    tiny_mpi::wait(_requests, sloc);
+}
+
+void
+tiny_mpi::persistent::_free()
+    noexcept
+{
+    if (not finalized()) {
+        // Active collectives may not be freed, so complete everything first.
+        tiny_mpi::wait(_requests);
+        for (request_t& r : _requests) {
+            if (r != MPI_REQUEST_NULL) {
+                check(sloc_t::current(), tiny_mpi_check_op(MPI_Request_free), &r);
+            }
+        }
+    }
+    _requests.clear();
+    _reposts.clear();
+}
+
+auto
+tiny_mpi::communicator::dist_graph(std::span<rank_t const> sources,
+                                   std::span<rank_t const> destinations,
+                                   bool reorder,
+                                   sloc_t sloc) const
+    noexcept -> communicator
+{
+    MPI_Comm out;
+    check(
+        sloc,
+        tiny_mpi_check_op(MPI_Dist_graph_create_adjacent),
+        _comm,
+        ssize(sources),
+        data(sources),
+        MPI_UNWEIGHTED,
+        ssize(destinations),
+        data(destinations),
+        MPI_UNWEIGHTED,
+        MPI_INFO_NULL,
+        reorder,
+        &out);
+    return _adopt(out, sloc);
+}
+
+auto
+tiny_mpi::communicator::neighbors(sloc_t sloc) const
+    noexcept -> std::pair<std::vector<rank_t>, std::vector<rank_t>>
+{
+    auto [in, out] = degrees(sloc);
+    std::pair<std::vector<rank_t>, std::vector<rank_t>> ranks(in, out);
+    check(
+        sloc,
+        tiny_mpi_check_op(MPI_Dist_graph_neighbors),
+        _comm,
+        in,
+        data(ranks.first),
+        MPI_UNWEIGHTED,
+        out,
+        data(ranks.second),
+        MPI_UNWEIGHTED);
+    return ranks;
+}
+
+auto
+tiny_mpi::communicator::degrees(sloc_t sloc) const
+    noexcept -> std::pair<int, int>
+{
+    int in, out, weighted;
+    check(sloc, tiny_mpi_check_op(MPI_Dist_graph_neighbors_count), _comm, &in, &out, &weighted);
+    return { in, out };
+}
+
+auto
+tiny_mpi::communicator::translate(std::span<rank_t const> ranks, communicator const& other, sloc_t sloc) const
+    noexcept -> std::vector<rank_t>
+{
+    MPI_Group from, to;
+    check(sloc, tiny_mpi_check_op(MPI_Comm_group), _comm, &from);
+    check(sloc, tiny_mpi_check_op(MPI_Comm_group), other, &to);
+
+    std::vector<rank_t> out(ranks.size());
+    check(sloc, tiny_mpi_check_op(MPI_Group_translate_ranks), from, ssize(ranks), data(ranks), to, data(out));
+
+    check(sloc, tiny_mpi_check_op(MPI_Group_free), &from);
+    check(sloc, tiny_mpi_check_op(MPI_Group_free), &to);
+    return out;
+}
+
+tiny_mpi::request_pool::~request_pool()
+{
+    if (not empty() and not finalized()) {
+        wait_all();
+    }
+}
+
+auto
+tiny_mpi::request_pool::add(request_t r)
+    -> int
+{
+    if (_free.empty()) {
+        _requests.push_back(r);
+        return _requests.size() - 1;
+    }
+
+    int i = _free.back();
+    _free.pop_back();
+    _requests[i] = r;
+    return i;
+}
+
+auto
+tiny_mpi::request_pool::wait_any(sloc_t sloc)
+    noexcept -> int
+{
+    int i;
+    check(sloc, tiny_mpi_check_op(MPI_Waitany), ssize(_requests), data(_requests), &i, MPI_STATUS_IGNORE);
+    if (i == MPI_UNDEFINED) {
+        return -1;
+    }
+
+    _free.push_back(i);
+    return i;
+}
+
+auto
+tiny_mpi::request_pool::wait_some(sloc_t sloc)
+    noexcept -> std::span<int const>
+{
+    int n;
+    _completed.resize(_requests.size());
+    check(sloc, tiny_mpi_check_op(MPI_Waitsome), ssize(_requests), data(_requests), &n, data(_completed), MPI_STATUSES_IGNORE);
+    return _retire(n);
+}
+
+auto
+tiny_mpi::request_pool::test_some(sloc_t sloc)
+    noexcept -> std::span<int const>
+{
+    int n;
+    _completed.resize(_requests.size());
+    check(sloc, tiny_mpi_check_op(MPI_Testsome), ssize(_requests), data(_requests), &n, data(_completed), MPI_STATUSES_IGNORE);
+    return _retire(n);
+}
+
+void
+tiny_mpi::request_pool::wait_all(sloc_t sloc)
+    noexcept
+{
+    tiny_mpi::wait(_requests, sloc);
+    _requests.clear();
+    _free.clear();
+}
+
+auto
+tiny_mpi::request_pool::_retire(int n)
+    -> std::span<int const>
+{
+    if (n == MPI_UNDEFINED) {
+        n = 0;
+    }
+
+    _completed.resize(n);
+    _free.insert(_free.end(), _completed.begin(), _completed.end());
+    return _completed;
+}
+
+auto
+tiny_mpi::commit_type(MPI_Datatype type, sloc_t sloc)
+    noexcept -> MPI_Datatype
+{
+    int n_integers, n_addresses, n_datatypes, combiner;
+    check(sloc, tiny_mpi_check_op(MPI_Type_get_envelope), type, &n_integers, &n_addresses, &n_datatypes, &combiner);
+    if (combiner == MPI_COMBINER_NAMED) {
+        return type;
+    }
+
+    check(sloc, tiny_mpi_check_op(MPI_Type_commit), &type);
+
+    std::scoped_lock _(_types_lock);
+    _types.push_back(type);
+    return type;
+}
+
+auto
+tiny_mpi::make_struct_type(std::span<int const> lengths,
+                           std::span<MPI_Aint const> offsets,
+                           std::span<MPI_Datatype const> types,
+                           MPI_Aint extent,
+                           sloc_t sloc)
+    noexcept -> MPI_Datatype
+{
+    MPI_Datatype packed;
+    check(sloc, tiny_mpi_check_op(MPI_Type_create_struct), ssize(lengths), data(lengths), data(offsets), data(types), &packed);
+
+    MPI_Datatype resized;
+    check(sloc, tiny_mpi_check_op(MPI_Type_create_resized), packed, 0, extent, &resized);
+    check(sloc, tiny_mpi_check_op(MPI_Type_free), &packed);
+    return commit_type(resized, sloc);
+}
+
+auto
+tiny_mpi::half_type(sloc_t sloc)
+    noexcept -> MPI_Datatype
+{
+    static MPI_Datatype const half = [&] {
+        MPI_Datatype t;
+        check(sloc, tiny_mpi_check_op(MPI_Type_contiguous), 1, MPI_UINT16_T, &t);
+        return commit_type(t, sloc);
+    }();
+    return half;
+}
+
+auto
+tiny_mpi::make_op(MPI_User_function* f, bool commutative, sloc_t sloc)
+    noexcept -> MPI_Op
+{
+    MPI_Op o;
+    check(sloc, tiny_mpi_check_op(MPI_Op_create), f, commutative, &o);
+
+    std::scoped_lock _(_ops_lock);
+    _ops.push_back(o);
+    return o;
+}
+
+auto
+tiny_mpi::strided_type(MPI_Datatype type,
+                       std::span<int const> extents,
+                       std::span<MPI_Aint const> strides,
+                       sloc_t sloc)
+    noexcept -> MPI_Datatype
+{
+    _strided_key_t key { type, { extents.begin(), extents.end() } };
+    key.second.insert(key.second.end(), strides.begin(), strides.end());
+
+    std::scoped_lock _(_strided_lock);
+    if (auto i = _strided.find(key); i != _strided.end()) {
+        return i->second;
+    }
+
+    MPI_Aint lb, extent;
+    check(sloc, tiny_mpi_check_op(MPI_Type_get_extent), type, &lb, &extent);
+
+    MPI_Datatype out = type;
+    for (std::size_t i = extents.size(); i-- != 0;) {
+        // Byte strides, an element stride can exceed INT_MAX.
+        MPI_Datatype inner = out;
+        check(sloc, tiny_mpi_check_op(MPI_Type_create_hvector), extents[i], 1, strides[i] * extent, inner, &out);
+        if (inner != type) {
+            check(sloc, tiny_mpi_check_op(MPI_Type_free), &inner);
+        }
+    }
+
+    return _strided[std::move(key)] = commit_type(out, sloc);
+}
+
+auto
+tiny_mpi::large_type(MPI_Datatype type, count_t n, sloc_t sloc)
+    noexcept -> MPI_Datatype
+{
+    std::scoped_lock _(_large_lock);
+    if (auto i = _large.find({ type, n }); i != _large.end()) {
+        return i->second;
+    }
+
+    // `q` chunks of `chunk` elements followed by `r` elements, resized so that
+    // the extent is exactly `n` elements.
+    constexpr count_t chunk = count_t(1) << 30;
+    count_t const q = n / chunk;
+    count_t const r = n % chunk;
+
+    MPI_Aint lb, extent;
+    check(sloc, tiny_mpi_check_op(MPI_Type_get_extent), type, &lb, &extent);
+
+    MPI_Datatype block, blocks, tail, joined, out;
+    check(sloc, tiny_mpi_check_op(MPI_Type_contiguous), int(chunk), type, &block);
+    check(sloc, tiny_mpi_check_op(MPI_Type_contiguous), int(q), block, &blocks);
+    check(sloc, tiny_mpi_check_op(MPI_Type_contiguous), int(r), type, &tail);
+
+    int const lengths[] = { 1, 1 };
+    MPI_Aint const offsets[] = { 0, MPI_Aint(q * chunk) * extent };
+    MPI_Datatype const types[] = { blocks, tail };
+    check(sloc, tiny_mpi_check_op(MPI_Type_create_struct), 2, lengths, offsets, types, &joined);
+    check(sloc, tiny_mpi_check_op(MPI_Type_create_resized), joined, lb, MPI_Aint(n) * extent, &out);
+
+    for (MPI_Datatype* t : { &block, &blocks, &tail, &joined }) {
+        check(sloc, tiny_mpi_check_op(MPI_Type_free), t);
+    }
+
+    return _large[{ type, n }] = commit_type(out, sloc);
+}
+
+auto
+tiny_mpi::world()
+    noexcept -> communicator const&
+{
+    // Constructed once, by init(), from the borrowed MPI_COMM_WORLD. MPI cannot
+    // be initialized again after fini(), so the cached rank and size hold.
+    static communicator const _world(MPI_COMM_WORLD);
+    return _world;
+}